@@ -0,0 +1,95 @@
+#ifndef CYANIDE_CODE_PATCH_HPP_
+#define CYANIDE_CODE_PATCH_HPP_
+
+#include <cyanide/defs.hpp>
+#include <cyanide/patch.hpp>
+
+#include <array>
+#include <cstddef>
+#include <span>
+
+namespace cyanide {
+
+/*
+ * Patches of the code which respect the instruction boundaries: the patch
+ * is extended to the end of the last instruction it touches (see
+ * cyanide::instruction_length), so no instruction is left half-overwritten.
+ *
+ *     // Remove the call, whatever its encoding
+ *     auto no_call = cyanide::make_nop_patch(call_address, 1);
+ *
+ *     // Replace the jnz with jmp, the rest of the jnz becomes NOPs
+ *     const std::array<cyanide::byte_t, 2> jmp{0xEB, 0x10};
+ *     auto always = cyanide::make_code_patch(jnz_address, jmp);
+ *
+ * The gaps are filled with the multi-byte NOPs recommended by Intel, so the
+ * CPU decodes one instruction per up to 9 bytes instead of one per byte.
+ */
+
+// Multi-byte NOPs from the Intel SDM, by the length minus one
+inline constexpr std::array<std::array<cyanide::byte_t, 9>, 9> nop_forms{{
+    {0x90},
+    {0x66, 0x90},
+    {0x0F, 0x1F, 0x00},
+    {0x0F, 0x1F, 0x40, 0x00},
+    {0x0F, 0x1F, 0x44, 0x00, 0x00},
+    {0x66, 0x0F, 0x1F, 0x44, 0x00, 0x00},
+    {0x0F, 0x1F, 0x80, 0x00, 0x00, 0x00, 0x00},
+    {0x0F, 0x1F, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00},
+    {0x66, 0x0F, 0x1F, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00}}};
+
+// Regions longer than this are jumped over instead of filled with NOPs
+inline constexpr std::size_t nop_jump_threshold = 32;
+
+// Fill the buffer with the longest NOPs, the shorter one goes last
+constexpr void fill_nops(std::span<cyanide::byte_t> buffer) noexcept
+{
+    while (!buffer.empty())
+    {
+        const std::size_t size =
+            buffer.size() < nop_forms.size() ? buffer.size() : nop_forms.size();
+
+        for (std::size_t i = 0; i < size; ++i)
+            buffer[i] = nop_forms[size - 1][i];
+
+        buffer = buffer.subspan(size);
+    }
+}
+
+/*
+ * Size of the whole instructions covering at least the given number of bytes
+ *
+ * @throw std::runtime_error If an instruction can't be decoded.
+ */
+[[nodiscard]] std::size_t
+instruction_boundary(const void *address, std::size_t min_size);
+
+/*
+ * Construct a patch that removes the instructions covering at least the given
+ * number of bytes. Each instruction is replaced by its own NOPs, so the
+ * branches to any of the original instructions still fall through to the end
+ * of the region. In the regions longer than cyanide::nop_jump_threshold bytes
+ * the first instruction long enough to hold a jmp past the end is replaced by
+ * it instead.
+ *
+ * @throw std::runtime_error If an instruction can't be decoded.
+ */
+[[nodiscard]] cyanide::patch<> make_nop_patch(
+    void       *address,
+    std::size_t min_size,
+    bool        unprotect = true);
+
+/*
+ * Construct a patch that writes the code and fills the rest of the last
+ * overwritten instruction with NOPs
+ *
+ * @throw std::runtime_error If an instruction can't be decoded.
+ */
+[[nodiscard]] cyanide::patch<> make_code_patch(
+    void                            *address,
+    std::span<const cyanide::byte_t> code,
+    bool                             unprotect = true);
+
+} // namespace cyanide
+
+#endif // !CYANIDE_CODE_PATCH_HPP_
@@ -0,0 +1,169 @@
+#ifndef CYANIDE_DEFERRED_HOOKS_HPP_
+#define CYANIDE_DEFERRED_HOOKS_HPP_
+
+#include <cyanide/signature.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <exception> // std::exception_ptr
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility> // std::move
+#include <variant>
+#include <vector>
+
+namespace cyanide {
+
+/*
+ * Registry of the hooks into the modules which may be not loaded yet:
+ *
+ *     cyanide::deferred_hooks hooks;
+ *
+ *     hooks.add<cyanide::polyhook_x86, int(__cdecl *)(int)>(
+ *         "plugin.dll",
+ *         0x1A20,
+ *         [](auto orig, int x) { return orig(x) + 1; });
+ *
+ * The hook is installed right away if the module is already loaded, otherwise
+ * from the loader notification (LdrRegisterDllNotification), i.e. after the
+ * module is mapped but before its entry point runs, so no call is missed. The
+ * hook is uninstalled when the module is unloaded and installed again when
+ * it's loaded the next time.
+ *
+ * The notifications are delivered with the loader lock held, so the callbacks
+ * of the hooks must not load libraries while being installed.
+ */
+class deferred_hooks {
+public:
+    // Installs the hook at the address, keeps it installed while it's alive
+    using installer_t = std::function<std::shared_ptr<void>(void *address)>;
+
+    // Hook location within the module
+    using location_t = std::variant<std::uintptr_t, cyanide::signature>;
+
+    /*
+     * @param on_error Called with the exception thrown while installing the
+     * hook from the loader notification (e.g. the signature wasn't found),
+     * must not throw.
+     */
+    explicit deferred_hooks(
+        std::function<void(std::exception_ptr)> on_error = {});
+
+    ~deferred_hooks();
+
+    deferred_hooks(const deferred_hooks &)            = delete;
+    deferred_hooks &operator=(const deferred_hooks &) = delete;
+
+    /*
+     * Hook the function once the module is loaded
+     *
+     * @tparam Hook Hook wrapper template, e.g. cyanide::polyhook_x86.
+     * @tparam SourceT Pointer to the hooked function type.
+     * @param module Module name, case-insensitive, e.g. "plugin.dll".
+     * @param offset Offset of the function from the module base.
+     * @param callback Hook callback, copied into every installed hook.
+     */
+    template <
+        template <typename...>
+        typename Hook,
+        typename SourceT,
+        typename CallbackT>
+    void add(std::string_view module, std::uintptr_t offset, CallbackT callback)
+    {
+        add_installer(
+            module,
+            location_t{offset},
+            make_installer<Hook, SourceT>(std::move(callback)));
+    }
+
+    /*
+     * Same as above, but the function is found by the signature
+     *
+     * @param sig Signature of the function, searched for in the executable
+     * sections of the module.
+     */
+    template <
+        template <typename...>
+        typename Hook,
+        typename SourceT,
+        typename CallbackT>
+    void add(
+        std::string_view   module,
+        cyanide::signature sig,
+        CallbackT          callback)
+    {
+        add_installer(
+            module,
+            location_t{std::move(sig)},
+            make_installer<Hook, SourceT>(std::move(callback)));
+    }
+
+    /*
+     * Same as add, but with the custom installer
+     *
+     * @throw std::runtime_error If the module is already loaded and the hook
+     * can't be installed.
+     */
+    void add_installer(
+        std::string_view module,
+        location_t       location,
+        installer_t      installer);
+
+    // Number of the hooks currently installed
+    [[nodiscard]] std::size_t installed_count() const;
+
+protected:
+    struct entry {
+        std::wstring module;
+        location_t   location;
+        installer_t  installer;
+
+        // Base of the module the hook is installed into, null if it isn't
+        std::uintptr_t        module_base = 0;
+        std::shared_ptr<void> installed;
+    };
+
+    std::function<void(std::exception_ptr)> on_error_;
+    mutable std::mutex                      mutex_;
+    std::vector<std::unique_ptr<entry>>     entries_;
+    void                                   *cookie_ = nullptr;
+
+    template <
+        template <typename...>
+        typename Hook,
+        typename SourceT,
+        typename CallbackT>
+    static installer_t make_installer(CallbackT callback)
+    {
+        return [callback = std::move(callback)](
+                   void *address) -> std::shared_ptr<void> {
+            auto hook = std::make_shared<Hook<SourceT, CallbackT>>(
+                reinterpret_cast<SourceT>(address),
+                CallbackT{callback});
+
+            hook->install();
+
+            return hook;
+        };
+    }
+
+    void install(entry &target, std::uintptr_t base, std::size_t size);
+
+    void on_loaded(
+        std::wstring_view module,
+        std::uintptr_t    base,
+        std::size_t       size);
+    void on_unloaded(std::uintptr_t base);
+
+    static void __stdcall notification(
+        unsigned long reason,
+        const void   *data,
+        void         *context);
+};
+
+} // namespace cyanide
+
+#endif // !CYANIDE_DEFERRED_HOOKS_HPP_
@@ -8,6 +8,9 @@ namespace cyanide {
 
 using byte_t = unsigned char;
 
+// Bytes written over the hook source, the jmp rel32 of the detour
+inline constexpr std::size_t hook_detour_size = 5;
+
 template <typename T>
 constexpr std::size_t get_type_size()
 {
@@ -0,0 +1,160 @@
+#ifndef CYANIDE_BOUNDED_QUEUE_HPP_
+#define CYANIDE_BOUNDED_QUEUE_HPP_
+
+#include <atomic>
+#include <bit> // std::bit_ceil
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace cyanide::detail {
+
+/*
+ * Bounded lock-free queue of multiple producers and multiple consumers
+ * (Dmitry Vyukov's design).
+ *
+ * Every cell carries a sequence number telling whether it's free for the
+ * producer of the given lap or ready for the consumer, so the sides only
+ * contend on their own index and the cell itself. The cells are preallocated,
+ * pushing never allocates.
+ */
+template <typename T>
+class bounded_queue {
+    static_assert(
+        std::is_trivially_copyable_v<T>,
+        "Elements are copied in and out by value");
+
+public:
+    // @param capacity Rounded up to the power of two.
+    explicit bounded_queue(std::size_t capacity)
+        : mask_{std::bit_ceil(capacity < 2 ? 2 : capacity) - 1},
+          cells_{std::make_unique<cell[]>(mask_ + 1)}
+    {
+        for (std::size_t i = 0; i <= mask_; ++i)
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    bounded_queue(const bounded_queue &)            = delete;
+    bounded_queue &operator=(const bounded_queue &) = delete;
+
+    // Fails if the queue is full
+    bool try_push(const T &value) noexcept
+    {
+        std::size_t position = enqueue_.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            cell &current = cells_[position & mask_];
+
+            const std::size_t sequence =
+                current.sequence.load(std::memory_order_acquire);
+
+            const auto difference = static_cast<std::ptrdiff_t>(
+                sequence - position);
+
+            if (difference == 0)
+            {
+                if (enqueue_.compare_exchange_weak(
+                        position,
+                        position + 1,
+                        std::memory_order_relaxed))
+                {
+                    current.value = value;
+                    current.sequence.store(
+                        position + 1,
+                        std::memory_order_release);
+
+                    return true;
+                }
+            }
+            else if (difference < 0)
+            {
+                // The consumer of the previous lap hasn't taken it yet
+                return false;
+            }
+            else
+            {
+                position = enqueue_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Fails if the queue is empty
+    bool try_pop(T &value) noexcept
+    {
+        std::size_t position = dequeue_.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            cell &current = cells_[position & mask_];
+
+            const std::size_t sequence =
+                current.sequence.load(std::memory_order_acquire);
+
+            const auto difference = static_cast<std::ptrdiff_t>(
+                sequence - (position + 1));
+
+            if (difference == 0)
+            {
+                if (dequeue_.compare_exchange_weak(
+                        position,
+                        position + 1,
+                        std::memory_order_relaxed))
+                {
+                    value = current.value;
+                    current.sequence.store(
+                        position + mask_ + 1,
+                        std::memory_order_release);
+
+                    return true;
+                }
+            }
+            else if (difference < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = dequeue_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Approximate while the other threads are pushing or popping
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        const std::size_t dequeued = dequeue_.load(std::memory_order_relaxed);
+        const std::size_t enqueued = enqueue_.load(std::memory_order_relaxed);
+
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+    // Number of the elements pushed since construction
+    [[nodiscard]] std::size_t pushed() const noexcept
+    {
+        return enqueue_.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] std::size_t capacity() const noexcept
+    {
+        return mask_ + 1;
+    }
+
+protected:
+    static constexpr std::size_t cache_line = 64;
+
+    struct cell {
+        std::atomic<std::size_t> sequence = 0;
+        T                        value{};
+    };
+
+    const std::size_t       mask_;
+    std::unique_ptr<cell[]> cells_;
+
+    alignas(cache_line) std::atomic<std::size_t> enqueue_ = 0;
+    alignas(cache_line) std::atomic<std::size_t> dequeue_ = 0;
+};
+
+} // namespace cyanide::detail
+
+#endif // !CYANIDE_BOUNDED_QUEUE_HPP_
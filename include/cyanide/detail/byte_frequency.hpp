@@ -0,0 +1,60 @@
+#ifndef CYANIDE_BYTE_FREQUENCY_HPP_
+#define CYANIDE_BYTE_FREQUENCY_HPP_
+
+#include <array>
+#include <cstdint>
+
+namespace cyanide::detail {
+
+/*
+ * Occurrences of every byte value per 64 KiB of x86 code. Used to pick the
+ * signature anchors, so only the relative order matters.
+ *
+ * Measured over the code sections (IMAGE_SCN_CNT_CODE) of 29 distinct 32-bit
+ * native PE images built with MSVC 6.0 to 14.x, about 9.7 MB in total
+ * (dbghelp, msdia140, the Python wininst and launcher stubs and such), .NET
+ * assemblies excluded. The counts are pooled over all the images and scaled
+ * to 64 KiB. The int3 padding (CC) is the 4th most common byte there, push
+ * ebp (55) is in the top 40, while 40-4F are inc / dec rather than the REX
+ * prefixes and are rare.
+ */
+// clang-format off
+inline constexpr std::array<std::uint16_t, 256> x86_byte_frequency{
+     8863,  1172,   591,   710,   976,   329,   310,   299, // 00
+     1090,   145,   189,   135,   707,   143,   119,   751, // 08
+     1504,   115,   141,    83,   428,   435,   116,   117, // 10
+      250,    57,    50,    77,   193,    52,    53,    59, // 18
+      326,    38,    55,    83,   494,    65,    33,    34, // 20
+      124,    34,    31,   171,   111,    57,    38,    27, // 28
+      166,    48,    78,   482,   101,    55,    50,    37, // 30
+      123,   112,    45,   326,   106,    92,    40,    48, // 38
+      355,   239,   157,   162,   221,   894,   395,   195, // 40
+      149,    80,    57,    74,   179,   434,   155,   105, // 48
+      663,   260,   151,   282,   127,   396,   396,   334, // 50
+       90,   176,    27,   209,    63,   501,   367,   334, // 58
+       93,    88,    35,    59,   143,   152,   265,    48, // 60
+      241,    81,   397,    37,    99,    54,    75,    80, // 68
+      140,    45,   165,   160,   851,   900,   103,    95, // 70
+      110,    55,    31,    41,    79,   219,    80,    75, // 78
+      335,   170,    57,  1089,   387,   984,   111,    97, // 80
+      141,  1117,   109,  3623,    67,   934,    57,    43, // 88
+      141,    23,    29,    36,    58,    73,    20,    20, // 90
+       61,    39,    16,    26,    53,    42,    22,    28, // 98
+       88,    94,    16,    54,    57,    45,    20,    15, // A0
+       59,    22,    21,    24,    48,    16,    21,    17, // A8
+      152,    27,    21,    29,    49,    76,   101,   148, // B0
+      203,    76,    52,    42,    65,    61,    92,    49, // B8
+      816,   314,   377,   315,   291,    58,   269,   704, // C0
+      213,   208,    72,    73,  1524,    72,   137,    99, // C8
+      220,    84,   115,    53,    79,    23,    97,    52, // D0
+      149,    61,    34,    96,    91,    31,    33,    36, // D8
+      216,    63,    43,    28,   164,   230,    34,    29, // E0
+     1104,   189,    33,   340,   454,    23,    37,    68, // E8
+      338,   102,    53,    88,   220,    36,   244,   196, // F0
+      419,   149,   100,   163,   418,   185,   271,  3618, // F8
+};
+// clang-format on
+
+} // namespace cyanide::detail
+
+#endif // !CYANIDE_BYTE_FREQUENCY_HPP_
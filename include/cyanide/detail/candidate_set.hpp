@@ -0,0 +1,463 @@
+#ifndef CYANIDE_CANDIDATE_SET_HPP_
+#define CYANIDE_CANDIDATE_SET_HPP_
+
+#include <cyanide/defs.hpp>
+
+#include <algorithm> // std::equal, std::fill, std::max, std::min
+#include <bit>       // std::popcount, std::countr_zero
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility> // std::move
+#include <vector>
+
+namespace cyanide::detail {
+
+/*
+ * Set of the addresses which still match the value scan, together with the
+ * values they held during the last scan.
+ *
+ * Every readable region is split into slots of `stride` bytes, each slot is a
+ * single bit in the region bitmap. Both parts of the snapshot are compressed:
+ *
+ * - The bitmap is run-length encoded, only the non-zero 64-bit words are
+ *   stored, each run of them preceded by the number of the zero words
+ *   skipped. The sparse candidates cost a word per cluster instead of a bit
+ *   per slot, the dense ones about the same as the raw bitmap.
+ * - The values are stored only for the set bits, packed in the bitmap order.
+ *   If all the candidates of the region hold the same value (e.g. after the
+ *   exact match), it's stored once.
+ *
+ * The regions without candidates are dropped entirely. Memory is read through
+ * the accessor in chunks of chunk_slots slots, chunks without candidates are
+ * not read at all during the subsequent scans.
+ */
+class candidate_set {
+public:
+    static constexpr std::size_t chunk_slots = 64 * 1024;
+    static constexpr std::size_t chunk_words = chunk_slots / 64;
+
+    static_assert(chunk_slots % 64 == 0);
+
+    // Zero words skipped, then as many non-zero words stored
+    struct run {
+        std::uint32_t zero_words    = 0;
+        std::uint32_t literal_words = 0;
+    };
+
+    struct region {
+        std::uintptr_t               base  = 0;
+        std::size_t                  slots = 0;
+        std::size_t                  count = 0;
+        std::vector<run>             runs;
+        std::vector<std::uint64_t>   literals;
+        std::vector<cyanide::byte_t> values;
+
+        // A single value is stored for all the candidates
+        bool uniform = false;
+    };
+
+    // Values of the candidates in the bitmap order
+    struct packed_values {
+        const cyanide::byte_t *data   = nullptr;
+        std::size_t            stride = 0;
+
+        const cyanide::byte_t *operator[](std::size_t index) const noexcept
+        {
+            return data + index * stride;
+        }
+    };
+
+    /*
+     * @param stride Distance between the adjacent slots.
+     * @param width Size of the value stored in each slot.
+     */
+    candidate_set(std::size_t stride, std::size_t width)
+        : stride_{stride},
+          width_{width},
+          buffer_((chunk_slots - 1) * stride + width),
+          bits_(chunk_words)
+    {}
+
+    /*
+     * Scan all the readable memory, replacing the current candidates
+     *
+     * @param matcher Callable void(std::span<const byte_t> chunk,
+     * std::size_t slots, std::uint64_t *bits), which sets the bits of the
+     * matching slots. The bits are zeroed beforehand.
+     */
+    template <typename Accessor, typename Matcher>
+    void first_pass(const Accessor &accessor, Matcher &&matcher)
+    {
+        regions_.clear();
+
+        for (const auto &memory : accessor.readable_regions())
+        {
+            if (memory.size < width_)
+                continue;
+
+            region current{memory.base, (memory.size - width_) / stride_ + 1};
+
+            bitmap_writer writer{current};
+
+            for (std::size_t first = 0; first < current.slots;
+                 first += chunk_slots)
+            {
+                const std::size_t slots =
+                    std::min(chunk_slots, current.slots - first);
+                const std::span<std::uint64_t> bits{
+                    bits_.data(),
+                    (slots + 63) / 64};
+
+                std::fill(bits.begin(), bits.end(), 0);
+
+                const auto [data, readable] =
+                    read_chunk(accessor, current.base + first * stride_, slots);
+
+                matcher(data, readable, bits.data());
+
+                pack_values(current, data, bits);
+                writer.append(bits);
+            }
+
+            if (current.count != 0)
+                regions_.push_back(std::move(current));
+        }
+    }
+
+    /*
+     * Re-scan the memory of the current candidates
+     *
+     * @param matcher Callable void(std::span<const byte_t> chunk,
+     * std::size_t slots, std::uint64_t *bits, packed_values previous), which
+     * clears the bits of the slots that don't match anymore. @p previous
+     * holds the values of the chunk candidates. The bits at or past @p slots
+     * may be left as is, they are cleared afterwards.
+     */
+    template <typename Accessor, typename Matcher>
+    void next_pass(const Accessor &accessor, Matcher &&matcher)
+    {
+        std::vector<region> survivors;
+
+        for (const auto &current : regions_)
+        {
+            region        next{current.base, current.slots};
+            bitmap_reader reader{current};
+            bitmap_writer writer{next};
+
+            const packed_values previous{
+                current.values.data(),
+                current.uniform ? 0 : width_};
+
+            std::size_t index = 0;
+
+            for (std::size_t first = 0; first < current.slots;
+                 first += chunk_slots)
+            {
+                const std::size_t slots =
+                    std::min(chunk_slots, current.slots - first);
+                const std::span<std::uint64_t> bits{
+                    bits_.data(),
+                    (slots + 63) / 64};
+
+                if (!reader.read(first / 64, bits))
+                {
+                    writer.skip(bits.size());
+                    continue;
+                }
+
+                const std::size_t candidates = count(bits);
+
+                const auto [data, readable] =
+                    read_chunk(accessor, current.base + first * stride_, slots);
+
+                matcher(
+                    data,
+                    readable,
+                    bits.data(),
+                    packed_values{previous[index], previous.stride});
+
+                // Slots past the readable part can't match anymore
+                clear_from(bits, readable);
+
+                index += candidates;
+
+                pack_values(next, data, bits);
+                writer.append(bits);
+            }
+
+            if (next.count != 0)
+                survivors.push_back(std::move(next));
+        }
+
+        regions_ = std::move(survivors);
+    }
+
+    // Call f(std::uintptr_t address, const byte_t *value) for every candidate
+    template <typename F>
+    void for_each(F &&f) const
+    {
+        for (const auto &current : regions_)
+        {
+            const std::size_t value_stride = current.uniform ? 0 : width_;
+
+            const cyanide::byte_t *value   = current.values.data();
+            const std::uint64_t   *literal = current.literals.data();
+            std::size_t            word    = 0;
+
+            for (const run &words : current.runs)
+            {
+                word += words.zero_words;
+
+                for (std::uint32_t i = 0; i < words.literal_words;
+                     ++i, ++word, ++literal)
+                {
+                    for (std::uint64_t bits = *literal; bits != 0;
+                         bits &= bits - 1)
+                    {
+                        const std::size_t slot =
+                            word * 64 + static_cast<std::size_t>(std::countr_zero(bits));
+
+                        f(current.base + slot * stride_, value);
+                        value += value_stride;
+                    }
+                }
+            }
+        }
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        std::size_t total = 0;
+
+        for (const auto &current : regions_)
+            total += current.count;
+
+        return total;
+    }
+
+    // Memory used by the snapshot, bitmaps included
+    [[nodiscard]] std::size_t memory_usage() const noexcept
+    {
+        std::size_t total = 0;
+
+        for (const auto &current : regions_)
+            total += current.runs.size() * sizeof(run)
+                   + current.literals.size() * sizeof(std::uint64_t)
+                   + current.values.size();
+
+        return total;
+    }
+
+    void clear() noexcept
+    {
+        regions_.clear();
+    }
+
+    [[nodiscard]] std::size_t stride() const noexcept
+    {
+        return stride_;
+    }
+
+protected:
+    std::size_t                  stride_{};
+    std::size_t                  width_{};
+    std::vector<region>          regions_;
+    std::vector<cyanide::byte_t> buffer_;
+
+    // Decoded bitmap of the current chunk
+    std::vector<std::uint64_t> bits_;
+
+    struct chunk {
+        std::span<const cyanide::byte_t> data;
+        std::size_t                      readable_slots = 0;
+    };
+
+    // Appends the words to the run-length encoded bitmap of the region
+    class bitmap_writer {
+    public:
+        explicit bitmap_writer(region &target) noexcept : target_{&target} {}
+
+        void append(std::span<const std::uint64_t> words)
+        {
+            for (const std::uint64_t word : words)
+            {
+                if (word == 0)
+                {
+                    ++zero_words_;
+                    continue;
+                }
+
+                // The zeros in between (or the first word) start a new run
+                if (zero_words_ != 0 || target_->runs.empty())
+                {
+                    target_->runs.push_back({zero_words_, 0});
+                    zero_words_ = 0;
+                }
+
+                ++target_->runs.back().literal_words;
+                target_->literals.push_back(word);
+            }
+        }
+
+        void skip(std::size_t words) noexcept
+        {
+            zero_words_ += static_cast<std::uint32_t>(words);
+        }
+
+    private:
+        region       *target_     = nullptr;
+        std::uint32_t zero_words_ = 0;
+    };
+
+    // Decodes the bitmap of the region, chunk by chunk in the ascending order
+    class bitmap_reader {
+    public:
+        explicit bitmap_reader(const region &source) noexcept
+            : source_{&source}
+        {
+            if (!source.runs.empty())
+                literal_begin_ = source.runs.front().zero_words;
+        }
+
+        // @return false if all the words are zero.
+        bool read(std::size_t first, std::span<std::uint64_t> words)
+        {
+            std::fill(words.begin(), words.end(), 0);
+
+            const std::size_t end = first + words.size();
+            bool              any = false;
+
+            while (run_ < source_->runs.size() && literal_begin_ < end)
+            {
+                const std::size_t run_end =
+                    literal_begin_ + source_->runs[run_].literal_words;
+
+                const std::size_t from = std::max(first, literal_begin_);
+                const std::size_t to   = std::min(end, run_end);
+
+                for (std::size_t word = from; word < to; ++word)
+                {
+                    words[word - first] = source_->literals
+                        [literal_offset_ + (word - literal_begin_)];
+                }
+
+                any |= from < to;
+
+                // The rest of the run belongs to the next chunk
+                if (run_end > end)
+                    break;
+
+                literal_offset_ += source_->runs[run_].literal_words;
+
+                if (++run_ < source_->runs.size())
+                    literal_begin_ = run_end + source_->runs[run_].zero_words;
+            }
+
+            return any;
+        }
+
+    private:
+        const region *source_         = nullptr;
+        std::size_t   run_            = 0;
+        std::size_t   literal_begin_  = 0;
+        std::size_t   literal_offset_ = 0;
+    };
+
+    template <typename Accessor>
+    chunk read_chunk(
+        const Accessor &accessor,
+        std::uintptr_t  address,
+        std::size_t     slots)
+    {
+        const std::size_t size = (slots - 1) * stride_ + width_;
+
+        const std::size_t bytes_read =
+            accessor.read(address, std::span{buffer_.data(), size});
+
+        const std::size_t readable =
+            bytes_read < width_
+                ? 0
+                : std::min(slots, (bytes_read - width_) / stride_ + 1);
+
+        return {std::span{buffer_.data(), bytes_read}, readable};
+    }
+
+    void pack_values(
+        region                          &target,
+        std::span<const cyanide::byte_t> data,
+        std::span<const std::uint64_t>   bits) const
+    {
+        for (std::size_t word = 0; word < bits.size(); ++word)
+        {
+            for (std::uint64_t current = bits[word]; current != 0;
+                 current &= current - 1)
+            {
+                const std::size_t slot =
+                    word * 64 + static_cast<std::size_t>(std::countr_zero(current));
+
+                pack_value(target, data.data() + slot * stride_);
+            }
+        }
+    }
+
+    void pack_value(region &target, const cyanide::byte_t *value) const
+    {
+        if (target.count == 0)
+        {
+            target.values.assign(value, value + width_);
+            target.uniform = true;
+        }
+        else if (
+            !target.uniform
+            || !std::equal(value, value + width_, target.values.begin()))
+        {
+            // The first different one, store the value for every candidate
+            if (target.uniform)
+            {
+                std::vector<cyanide::byte_t> expanded;
+                expanded.reserve((target.count + 1) * width_);
+
+                for (std::size_t i = 0; i < target.count; ++i)
+                {
+                    expanded.insert(
+                        expanded.end(),
+                        target.values.begin(),
+                        target.values.end());
+                }
+
+                target.values  = std::move(expanded);
+                target.uniform = false;
+            }
+
+            target.values.insert(target.values.end(), value, value + width_);
+        }
+
+        ++target.count;
+    }
+
+    static std::size_t count(std::span<const std::uint64_t> bits) noexcept
+    {
+        std::size_t total = 0;
+
+        for (const std::uint64_t word : bits)
+            total += static_cast<std::size_t>(std::popcount(word));
+
+        return total;
+    }
+
+    static void clear_from(std::span<std::uint64_t> bits, std::size_t slot)
+    {
+        for (std::size_t word = slot / 64; word < bits.size(); ++word)
+        {
+            const std::size_t first = word * 64;
+
+            bits[word] &= slot > first ? (std::uint64_t{1} << (slot - first)) - 1
+                                       : 0;
+        }
+    }
+};
+
+} // namespace cyanide::detail
+
+#endif // !CYANIDE_CANDIDATE_SET_HPP_
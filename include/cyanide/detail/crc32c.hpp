@@ -0,0 +1,99 @@
+#ifndef CYANIDE_CRC32C_HPP_
+#define CYANIDE_CRC32C_HPP_
+
+#include <cyanide/defs.hpp>
+#include <cyanide/detail/simd.hpp>
+#include <cyanide/safe_pun.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace cyanide::detail {
+
+constexpr std::array<std::uint32_t, 256> make_crc32c_table() noexcept
+{
+    // Reflected Castagnoli polynomial
+    constexpr std::uint32_t polynomial = 0x82F63B78;
+
+    std::array<std::uint32_t, 256> table{};
+
+    for (std::uint32_t i = 0; i < table.size(); ++i)
+    {
+        std::uint32_t crc = i;
+
+        for (int bit = 0; bit < 8; ++bit)
+            crc = (crc & 1) != 0 ? (crc >> 1) ^ polynomial : crc >> 1;
+
+        table[i] = crc;
+    }
+
+    return table;
+}
+
+inline constexpr std::array<std::uint32_t, 256> crc32c_table =
+    make_crc32c_table();
+
+// Bytewise, with the table
+inline std::uint32_t crc32c_update_table(
+    std::uint32_t          crc,
+    const cyanide::byte_t *current,
+    const cyanide::byte_t *end) noexcept
+{
+    for (; current != end; ++current)
+        crc = (crc >> 8) ^ crc32c_table[(crc ^ *current) & 0xFF];
+
+    return crc;
+}
+
+// With the crc32 instruction, the caller checks it's supported
+CYANIDE_TARGET_SSE42 inline std::uint32_t crc32c_update_sse42(
+    std::uint32_t          crc,
+    const cyanide::byte_t *current,
+    const cyanide::byte_t *end) noexcept
+{
+#if defined _M_X64 || defined __x86_64__
+    std::uint64_t wide = crc;
+
+    for (; end - current >= 8; current += 8)
+        wide = _mm_crc32_u64(wide, cyanide::safe_pun<std::uint64_t>(current));
+
+    crc = static_cast<std::uint32_t>(wide);
+#endif
+
+    for (; end - current >= 4; current += 4)
+        crc = _mm_crc32_u32(crc, cyanide::safe_pun<std::uint32_t>(current));
+
+    for (; current != end; ++current)
+        crc = _mm_crc32_u8(crc, *current);
+
+    return crc;
+}
+
+/*
+ * CRC32C (Castagnoli) checksum, uses the SSE4.2 crc32 instruction when the CPU
+ * supports it (checked at runtime unless enabled at compile time), the table
+ * otherwise.
+ *
+ * @param data Data to checksum.
+ * @param previous Checksum of the preceding data to continue from, zero for
+ * the first block.
+ */
+inline std::uint32_t crc32c(
+    std::span<const cyanide::byte_t> data,
+    std::uint32_t                    previous = 0) noexcept
+{
+    const cyanide::byte_t *begin = data.data();
+    const cyanide::byte_t *end   = begin + data.size();
+
+    const std::uint32_t crc = cpu_supports_sse42()
+                                ? crc32c_update_sse42(~previous, begin, end)
+                                : crc32c_update_table(~previous, begin, end);
+
+    return ~crc;
+}
+
+} // namespace cyanide::detail
+
+#endif // !CYANIDE_CRC32C_HPP_
@@ -0,0 +1,112 @@
+#ifndef CYANIDE_GATHER_HPP_
+#define CYANIDE_GATHER_HPP_
+
+#include <cyanide/defs.hpp>
+#include <cyanide/detail/prefetch.hpp>
+#include <cyanide/detail/simd.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring> // std::memcpy
+#include <limits>
+
+namespace cyanide::detail {
+
+/*
+ * Copy the values lying at the fixed distance from each other into the
+ * contiguous output. 4- and 8-byte values are gathered with AVX2 (if enabled),
+ * 8 and 4 values per step respectively.
+ *
+ * @param data Address of the first value, doesn't have to be aligned.
+ * @param stride Distance between the values in bytes.
+ * @param prefetch_distance Number of the values ahead to prefetch, zero
+ * disables prefetching.
+ */
+template <typename T>
+void gather_strided(
+    const cyanide::byte_t *data,
+    std::size_t            stride,
+    std::size_t            count,
+    T                     *output,
+    std::size_t            prefetch_distance = 0) noexcept
+{
+    if (stride == sizeof(T) && prefetch_distance == 0)
+    {
+        std::memcpy(output, data, count * sizeof(T));
+        return;
+    }
+
+    // Only within the range, prefetching past the end is wasted
+    const auto prefetch_ahead = [=](std::size_t index) {
+        if (prefetch_distance != 0 && index + prefetch_distance < count)
+            prefetch(data + (index + prefetch_distance) * stride);
+    };
+
+    std::size_t i = 0;
+
+#if defined CYANIDE_SIMD_AVX2
+    constexpr std::size_t max_index = std::numeric_limits<std::int32_t>::max();
+
+    if constexpr (sizeof(T) == 4)
+    {
+        if (stride <= max_index / 7)
+        {
+            const auto step = static_cast<std::int32_t>(stride);
+
+            const __m256i offsets = _mm256_mullo_epi32(
+                _mm256_set1_epi32(step),
+                _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+
+            for (; i + 8 <= count; i += 8)
+            {
+                for (std::size_t lane = 0; lane < 8; ++lane)
+                    prefetch_ahead(i + lane);
+
+                const __m256i values = _mm256_i32gather_epi32(
+                    reinterpret_cast<const int *>(data + i * stride),
+                    offsets,
+                    1);
+
+                _mm256_storeu_si256(
+                    reinterpret_cast<__m256i *>(output + i),
+                    values);
+            }
+        }
+    }
+    else if constexpr (sizeof(T) == 8)
+    {
+        if (stride <= max_index / 3)
+        {
+            const auto step = static_cast<std::int32_t>(stride);
+
+            const __m128i offsets = _mm_setr_epi32(0, step, 2 * step, 3 * step);
+
+            for (; i + 4 <= count; i += 4)
+            {
+                for (std::size_t lane = 0; lane < 4; ++lane)
+                    prefetch_ahead(i + lane);
+
+                const __m256i values = _mm256_i32gather_epi64(
+                    reinterpret_cast<const long long *>(data + i * stride),
+                    offsets,
+                    1);
+
+                _mm256_storeu_si256(
+                    reinterpret_cast<__m256i *>(output + i),
+                    values);
+            }
+        }
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        prefetch_ahead(i);
+
+        std::memcpy(output + i, data + i * stride, sizeof(T));
+    }
+}
+
+} // namespace cyanide::detail
+
+#endif // !CYANIDE_GATHER_HPP_
@@ -0,0 +1,22 @@
+#ifndef CYANIDE_PREFETCH_HPP_
+#define CYANIDE_PREFETCH_HPP_
+
+#if defined _MSC_VER
+    #include <xmmintrin.h> // _mm_prefetch
+#endif
+
+namespace cyanide::detail {
+
+// Hint the CPU to bring the cache line into the cache, never faults
+inline void prefetch(const void *address) noexcept
+{
+#if defined _MSC_VER
+    _mm_prefetch(static_cast<const char *>(address), _MM_HINT_T0);
+#else
+    __builtin_prefetch(address);
+#endif
+}
+
+} // namespace cyanide::detail
+
+#endif // !CYANIDE_PREFETCH_HPP_
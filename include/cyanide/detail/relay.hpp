@@ -2,10 +2,13 @@
 #define CYANIDE_RELAY_HPP_
 
 #include <cstdint>
-#include <utility> // std::forward
+#include <intrin.h> // _ReturnAddress
 
 namespace cyanide::detail {
 
+// Return address of the hooked call, set by the relay before the callback
+inline thread_local std::uintptr_t hook_return_address = 0;
+
 template <typename, typename>
 struct relay {};
 
@@ -18,16 +21,20 @@ struct relay<HookWrapperT, Ret(__cdecl *)(Args...)> {
         std::uintptr_t return_addr,
         Args... args)
     {
-        // See explanation why it's unused in make_relay() function
-        static_cast<void>(return_addr);
+        // The thunk has called the relay, so the original return address is
+        // passed as argument, see generate_relay_jump() function
+        hook_return_address = return_addr;
 
         const auto callable_source = reinterpret_cast<SourceT>(
             hook_wrapper->hook_impl_->get_trampoline());
 
+        // Calls from the callback go straight to the original
+        const auto guard = hook_wrapper->enter_callback();
+
         return hook_wrapper->callback_dispatcher(
             callable_source,
             hook_wrapper->callback_,
-            std::forward<Args>(args)...);
+            args...);
     }
 };
 
@@ -40,10 +47,17 @@ struct relay<HookWrapperT, Ret(__stdcall *)(Args...)> {
         const auto callable_source = reinterpret_cast<SourceT>(
             hook_wrapper->hook_impl_->get_trampoline());
 
+        // The thunk has jumped to the relay with the original return address
+        hook_return_address =
+            reinterpret_cast<std::uintptr_t>(_ReturnAddress());
+
+        // Calls from the callback go straight to the original
+        const auto guard = hook_wrapper->enter_callback();
+
         return hook_wrapper->callback_dispatcher(
             callable_source,
             hook_wrapper->callback_,
-            std::forward<Args>(args)...);
+            args...);
     }
 };
 
@@ -56,10 +70,17 @@ struct relay<HookWrapperT, Ret(__thiscall *)(Args...)> {
         const auto callable_source = reinterpret_cast<SourceT>(
             hook_wrapper->hook_impl_->get_trampoline());
 
+        // The thunk has jumped to the relay with the original return address
+        hook_return_address =
+            reinterpret_cast<std::uintptr_t>(_ReturnAddress());
+
+        // Calls from the callback go straight to the original
+        const auto guard = hook_wrapper->enter_callback();
+
         return hook_wrapper->callback_dispatcher(
             callable_source,
             hook_wrapper->callback_,
-            std::forward<Args>(args)...);
+            args...);
     }
 };
 
@@ -79,10 +100,17 @@ struct relay<HookWrapperT, Ret(__fastcall *)(Args...)> {
         const auto callable_source = reinterpret_cast<SourceT>(
             hook_wrapper->hook_impl_->get_trampoline());
 
+        // The thunk has jumped to the relay with the original return address
+        hook_return_address =
+            reinterpret_cast<std::uintptr_t>(_ReturnAddress());
+
+        // Calls from the callback go straight to the original
+        const auto guard = hook_wrapper->enter_callback();
+
         return hook_wrapper->callback_dispatcher(
             callable_source,
             hook_wrapper->callback_,
-            std::forward<Args>(args)...);
+            args...);
     }
 };
 
@@ -0,0 +1,76 @@
+#ifndef CYANIDE_SIMD_HPP_
+#define CYANIDE_SIMD_HPP_
+
+/*
+ * Instruction sets available at compile time. AVX2 has to be enabled
+ * explicitly (see CYANIDE_ENABLE_AVX2 option), SSE2 is there by default on
+ * every x86 compiler we care about. SSE4.2 is implied by AVX, MSVC has no
+ * separate switch for it.
+ */
+
+#if defined __AVX2__
+    #define CYANIDE_SIMD_AVX2
+#endif
+
+#if defined __SSE4_2__ || defined __AVX__ || defined CYANIDE_SIMD_AVX2
+    #define CYANIDE_SIMD_SSE42
+#endif
+
+#if defined __SSE2__ || defined _M_X64                                         \
+    || (defined _M_IX86_FP && _M_IX86_FP >= 2) || defined CYANIDE_SIMD_AVX2
+    #define CYANIDE_SIMD_SSE2
+#endif
+
+#if defined CYANIDE_SIMD_AVX2
+    #include <immintrin.h>
+#elif defined CYANIDE_SIMD_SSE42
+    #include <nmmintrin.h>
+#elif defined CYANIDE_SIMD_SSE2
+    #include <emmintrin.h>
+#endif
+
+/*
+ * SSE4.2 may still be used without the compile time switch, in the functions
+ * marked with CYANIDE_TARGET_SSE42 and after checking cpu_supports_sse42().
+ * MSVC accepts the intrinsics anywhere, GCC and Clang need the attribute.
+ */
+
+#if !defined CYANIDE_SIMD_SSE42
+    #include <nmmintrin.h>
+#endif
+
+#if defined _MSC_VER && !defined __clang__
+    #include <intrin.h> // __cpuid
+
+    #define CYANIDE_TARGET_SSE42
+#else
+    #define CYANIDE_TARGET_SSE42 __attribute__((target("sse4.2")))
+#endif
+
+namespace cyanide::detail {
+
+// Checked once, the result is cached
+inline bool cpu_supports_sse42() noexcept
+{
+#if defined CYANIDE_SIMD_SSE42
+    return true;
+#elif defined _MSC_VER && !defined __clang__
+    static const bool supported = [] {
+        int info[4]{};
+        __cpuid(info, 1);
+
+        // CPUID.01H:ECX.SSE42[bit 20]
+        return (info[2] & (1 << 20)) != 0;
+    }();
+
+    return supported;
+#else
+    static const bool supported = __builtin_cpu_supports("sse4.2") != 0;
+
+    return supported;
+#endif
+}
+
+} // namespace cyanide::detail
+
+#endif // !CYANIDE_SIMD_HPP_
@@ -0,0 +1,98 @@
+#ifndef CYANIDE_SPSC_RING_HPP_
+#define CYANIDE_SPSC_RING_HPP_
+
+#include <atomic>
+#include <bit> // std::bit_ceil
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace cyanide::detail {
+
+/*
+ * Bounded lock-free queue of a single producer and a single consumer.
+ *
+ * Each side caches the last seen index of the other one, so the shared cache
+ * line is only touched when the cached index says the ring looks full (or
+ * empty).
+ */
+template <typename T>
+class spsc_ring {
+    static_assert(
+        std::is_trivially_copyable_v<T>,
+        "Elements are copied in and out by value");
+
+public:
+    // @param capacity Rounded up to the power of two.
+    explicit spsc_ring(std::size_t capacity)
+        : mask_{std::bit_ceil(capacity < 2 ? 2 : capacity) - 1},
+          data_{std::make_unique<T[]>(mask_ + 1)}
+    {}
+
+    spsc_ring(const spsc_ring &)            = delete;
+    spsc_ring &operator=(const spsc_ring &) = delete;
+
+    // Producer side, fails if the ring is full
+    bool try_push(const T &value) noexcept
+    {
+        const std::size_t tail = producer_.index.load(
+            std::memory_order_relaxed);
+
+        if (tail - producer_.cached > mask_)
+        {
+            producer_.cached = consumer_.index.load(std::memory_order_acquire);
+
+            if (tail - producer_.cached > mask_)
+                return false;
+        }
+
+        data_[tail & mask_] = value;
+        producer_.index.store(tail + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    /*
+     * Consumer side, append all the available elements to the output
+     *
+     * @return Number of the elements popped.
+     */
+    std::size_t drain(std::vector<T> &output)
+    {
+        const std::size_t head = consumer_.index.load(
+            std::memory_order_relaxed);
+
+        consumer_.cached = producer_.index.load(std::memory_order_acquire);
+
+        for (std::size_t i = head; i != consumer_.cached; ++i)
+            output.push_back(data_[i & mask_]);
+
+        consumer_.index.store(consumer_.cached, std::memory_order_release);
+
+        return consumer_.cached - head;
+    }
+
+    [[nodiscard]] std::size_t capacity() const noexcept
+    {
+        return mask_ + 1;
+    }
+
+protected:
+    static constexpr std::size_t cache_line = 64;
+
+    // Index owned by one side and the cached index of the other one
+    struct alignas(cache_line) side {
+        std::atomic<std::size_t> index  = 0;
+        std::size_t              cached = 0;
+    };
+
+    const std::size_t    mask_;
+    std::unique_ptr<T[]> data_;
+    side                 producer_;
+    side                 consumer_;
+};
+
+} // namespace cyanide::detail
+
+#endif // !CYANIDE_SPSC_RING_HPP_
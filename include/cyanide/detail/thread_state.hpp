@@ -0,0 +1,74 @@
+#ifndef CYANIDE_THREAD_STATE_HPP_
+#define CYANIDE_THREAD_STATE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cyanide::detail {
+
+// Per-thread state of a single hook, read directly by the generated thunks
+struct hook_thread_state {
+    // Non-zero while the thread is inside the callback or bypasses the hook
+    std::uint32_t depth = 0;
+
+    // Calls left to skip before the sampled callback is entered again
+    std::uint32_t countdown = 0;
+};
+
+/*
+ * Per-thread blocks of hook states, one entry per hook slot.
+ *
+ * The pointer to the block of the current thread is stored in a single TLS
+ * slot, so that the thunk reaches it with a single fs-relative load. The block
+ * is allocated on the first use and freed on the thread exit, the thunks treat
+ * the null block as all-zero states.
+ */
+class thread_state {
+public:
+    static constexpr std::size_t max_hooks = 1024;
+
+    // Layout of the 32-bit TEB, the thunks read the TLS slots through fs
+    static constexpr std::size_t teb_tls_slots           = 0xE10;
+    static constexpr std::size_t teb_tls_expansion_slots = 0xF94;
+    static constexpr std::size_t tls_minimum_available   = 64;
+
+    // Index of the TLS slot holding the block pointer
+    [[nodiscard]] static unsigned long tls_index();
+
+    // Block of the calling thread, allocated if there is none yet
+    [[nodiscard]] static hook_thread_state *current();
+
+    /*
+     * @throw std::runtime_error If all the slots are taken.
+     */
+    [[nodiscard]] static std::size_t acquire_slot();
+
+    // Resets the state of the slot in the blocks of all the threads
+    static void release_slot(std::size_t slot) noexcept;
+};
+
+// Marks the thread as being inside the hook for the guard lifetime
+class depth_guard {
+public:
+    explicit depth_guard(hook_thread_state *state) noexcept : state_{state}
+    {
+        if (state_)
+            ++state_->depth;
+    }
+
+    ~depth_guard()
+    {
+        if (state_)
+            --state_->depth;
+    }
+
+    depth_guard(const depth_guard &)            = delete;
+    depth_guard &operator=(const depth_guard &) = delete;
+
+protected:
+    hook_thread_state *state_ = nullptr;
+};
+
+} // namespace cyanide::detail
+
+#endif // !CYANIDE_THREAD_STATE_HPP_
@@ -0,0 +1,143 @@
+#ifndef CYANIDE_THUNK_TEMPLATE_HPP_
+#define CYANIDE_THUNK_TEMPLATE_HPP_
+
+#include <cyanide/defs.hpp>
+#include <cyanide/function_traits.hpp>
+
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+
+namespace cyanide::detail {
+
+namespace opcode {
+    inline constexpr cyanide::byte_t push_eax   = 0x50;
+    inline constexpr cyanide::byte_t push_ecx   = 0x51;
+    inline constexpr cyanide::byte_t push_edx   = 0x52;
+    inline constexpr cyanide::byte_t pop_eax    = 0x58;
+    inline constexpr cyanide::byte_t pop_edx    = 0x5A;
+    inline constexpr cyanide::byte_t push_imm32 = 0x68;
+    inline constexpr cyanide::byte_t ret        = 0xC3;
+    inline constexpr cyanide::byte_t call_rel32 = 0xE8;
+    inline constexpr cyanide::byte_t jmp_rel32  = 0xE9;
+
+    // add esp, imm8
+    inline constexpr cyanide::byte_t add_esp_imm8[] = {0x83, 0xC4};
+} // namespace opcode
+
+/*
+ * Pre-assembled relay thunk, the same code as hook_wrapper generates with
+ * Xbyak when no thunk options are set. Only the wrapper pointer and the relay
+ * address vary, they are patched in after the template is copied.
+ */
+struct thunk_template {
+    static constexpr std::size_t max_size = 32;
+
+    std::array<cyanide::byte_t, max_size> code{};
+    std::size_t                           size = 0;
+
+    // Offset of the imm32 of `push this`
+    std::size_t wrapper_offset = 0;
+
+    // Offset of the rel32 of the call / jmp to the relay
+    std::size_t relay_offset = 0;
+};
+
+consteval cyanide::detail::thunk_template make_thunk_template(
+    cyanide::types::calling_conv conv,
+    bool                         hidden_param_return)
+{
+    using cyanide::types::calling_conv;
+
+    thunk_template result;
+
+    const auto emit = [&result](std::initializer_list<cyanide::byte_t> bytes) {
+        for (const cyanide::byte_t value : bytes)
+            result.code[result.size++] = value;
+    };
+
+    // Opcode followed by the 4-byte operand, the operand offset is returned
+    const auto emit_imm32 = [&result](cyanide::byte_t op) {
+        result.code[result.size++] = op;
+        result.size += 4;
+
+        return result.size - 4;
+    };
+
+    // See the stack layout explanation in hook_wrapper::generate_relay_jump
+    if (conv == calling_conv::ccdecl)
+    {
+        if (hidden_param_return)
+            emit({opcode::pop_eax, opcode::pop_edx, opcode::push_eax});
+
+        result.wrapper_offset = emit_imm32(opcode::push_imm32);
+
+        if (hidden_param_return)
+            emit({opcode::push_edx});
+
+        result.relay_offset = emit_imm32(opcode::call_rel32);
+
+        if (hidden_param_return)
+        {
+            emit({opcode::pop_eax});
+            emit({opcode::add_esp_imm8[0], opcode::add_esp_imm8[1], 4});
+            emit({opcode::pop_edx, opcode::push_eax, opcode::push_edx});
+        }
+        else
+        {
+            emit({opcode::add_esp_imm8[0], opcode::add_esp_imm8[1], 4});
+        }
+
+        emit({opcode::ret});
+    }
+    else
+    {
+        emit({opcode::pop_eax});
+
+        if (hidden_param_return)
+            emit({opcode::pop_edx});
+
+        if (conv == calling_conv::cthiscall)
+            emit({opcode::push_ecx});
+
+        result.wrapper_offset = emit_imm32(opcode::push_imm32);
+
+        if (hidden_param_return)
+            emit({opcode::push_edx});
+
+        emit({opcode::push_eax});
+        result.relay_offset = emit_imm32(opcode::jmp_rel32);
+    }
+
+    return result;
+}
+
+// Template for the function type
+template <typename SourceT>
+inline constexpr cyanide::detail::thunk_template thunk_template_v =
+    make_thunk_template(
+        cyanide::types::function_convention_v<SourceT>,
+        cyanide::get_type_size<cyanide::types::result_type_t<SourceT>>() > 8);
+
+/*
+ * Executable memory for the thunks, allocated in chunks and never returned to
+ * the OS, the released slots are reused
+ */
+class thunk_arena {
+public:
+    static constexpr std::size_t slot_size = thunk_template::max_size;
+
+    /*
+     * @throw std::runtime_error If VirtualAlloc fails.
+     */
+    [[nodiscard]] static cyanide::byte_t *allocate();
+
+    // Make the written code visible to the instruction fetch
+    static void commit(const cyanide::byte_t *slot) noexcept;
+
+    static void release(const cyanide::byte_t *slot) noexcept;
+};
+
+} // namespace cyanide::detail
+
+#endif // !CYANIDE_THUNK_TEMPLATE_HPP_
@@ -0,0 +1,349 @@
+#ifndef CYANIDE_VALUE_COMPARE_HPP_
+#define CYANIDE_VALUE_COMPARE_HPP_
+
+#include <cyanide/defs.hpp>
+#include <cyanide/detail/simd.hpp>
+#include <cyanide/safe_pun.hpp>
+
+#include <algorithm> // std::min
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace cyanide {
+
+enum class scan_condition {
+    // Compared with the specified value
+    equal,
+    not_equal,
+    greater,
+    less,
+
+    // Compared with the value from the previous scan
+    changed,
+    unchanged,
+    increased,
+    decreased
+};
+
+} // namespace cyanide
+
+namespace cyanide::detail {
+
+constexpr bool is_relative(cyanide::scan_condition condition) noexcept
+{
+    return condition >= cyanide::scan_condition::changed;
+}
+
+template <typename T>
+bool holds(cyanide::scan_condition condition, T current, T other) noexcept
+{
+    switch (condition)
+    {
+        case cyanide::scan_condition::equal:
+        case cyanide::scan_condition::unchanged:
+            return current == other;
+
+        case cyanide::scan_condition::not_equal:
+        case cyanide::scan_condition::changed:
+            return current != other;
+
+        case cyanide::scan_condition::greater:
+        case cyanide::scan_condition::increased:
+            return current > other;
+
+        case cyanide::scan_condition::less:
+        case cyanide::scan_condition::decreased:
+            return current < other;
+    }
+
+    return false;
+}
+
+template <typename T>
+inline constexpr bool is_vectorizable_v =
+    sizeof(T) == 4 && (std::is_integral_v<T> || std::is_same_v<T, float>);
+
+#if defined CYANIDE_SIMD_SSE2
+    #if defined CYANIDE_SIMD_AVX2
+using vector_i = __m256i;
+using vector_f = __m256;
+
+constexpr std::size_t vector_lanes = 8;
+
+inline vector_i load_i(const cyanide::byte_t *data) noexcept
+{
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+}
+
+inline vector_f load_f(const cyanide::byte_t *data) noexcept
+{
+    return _mm256_loadu_ps(reinterpret_cast<const float *>(data));
+}
+
+inline unsigned int mask_i(vector_i value) noexcept
+{
+    return static_cast<unsigned int>(
+        _mm256_movemask_ps(_mm256_castsi256_ps(value)));
+}
+
+inline unsigned int mask_f(vector_f value) noexcept
+{
+    return static_cast<unsigned int>(_mm256_movemask_ps(value));
+}
+
+inline vector_i broadcast_i(std::int32_t value) noexcept
+{
+    return _mm256_set1_epi32(value);
+}
+
+inline vector_f broadcast_f(float value) noexcept
+{
+    return _mm256_set1_ps(value);
+}
+
+inline vector_i xor_i(vector_i lhs, vector_i rhs) noexcept
+{
+    return _mm256_xor_si256(lhs, rhs);
+}
+
+inline vector_i cmpeq_i(vector_i lhs, vector_i rhs) noexcept
+{
+    return _mm256_cmpeq_epi32(lhs, rhs);
+}
+
+inline vector_i cmpgt_i(vector_i lhs, vector_i rhs) noexcept
+{
+    return _mm256_cmpgt_epi32(lhs, rhs);
+}
+
+inline vector_f cmpeq_f(vector_f lhs, vector_f rhs) noexcept
+{
+    return _mm256_cmp_ps(lhs, rhs, _CMP_EQ_OQ);
+}
+
+inline vector_f cmpneq_f(vector_f lhs, vector_f rhs) noexcept
+{
+    return _mm256_cmp_ps(lhs, rhs, _CMP_NEQ_UQ);
+}
+
+inline vector_f cmpgt_f(vector_f lhs, vector_f rhs) noexcept
+{
+    return _mm256_cmp_ps(lhs, rhs, _CMP_GT_OQ);
+}
+    #else
+using vector_i = __m128i;
+using vector_f = __m128;
+
+constexpr std::size_t vector_lanes = 4;
+
+inline vector_i load_i(const cyanide::byte_t *data) noexcept
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+}
+
+inline vector_f load_f(const cyanide::byte_t *data) noexcept
+{
+    return _mm_loadu_ps(reinterpret_cast<const float *>(data));
+}
+
+inline unsigned int mask_i(vector_i value) noexcept
+{
+    return static_cast<unsigned int>(_mm_movemask_ps(_mm_castsi128_ps(value)));
+}
+
+inline unsigned int mask_f(vector_f value) noexcept
+{
+    return static_cast<unsigned int>(_mm_movemask_ps(value));
+}
+
+inline vector_i broadcast_i(std::int32_t value) noexcept
+{
+    return _mm_set1_epi32(value);
+}
+
+inline vector_f broadcast_f(float value) noexcept
+{
+    return _mm_set1_ps(value);
+}
+
+inline vector_i xor_i(vector_i lhs, vector_i rhs) noexcept
+{
+    return _mm_xor_si128(lhs, rhs);
+}
+
+inline vector_i cmpeq_i(vector_i lhs, vector_i rhs) noexcept
+{
+    return _mm_cmpeq_epi32(lhs, rhs);
+}
+
+inline vector_i cmpgt_i(vector_i lhs, vector_i rhs) noexcept
+{
+    return _mm_cmpgt_epi32(lhs, rhs);
+}
+
+inline vector_f cmpeq_f(vector_f lhs, vector_f rhs) noexcept
+{
+    return _mm_cmpeq_ps(lhs, rhs);
+}
+
+inline vector_f cmpneq_f(vector_f lhs, vector_f rhs) noexcept
+{
+    return _mm_cmpneq_ps(lhs, rhs);
+}
+
+inline vector_f cmpgt_f(vector_f lhs, vector_f rhs) noexcept
+{
+    return _mm_cmpgt_ps(lhs, rhs);
+}
+    #endif
+
+/*
+ * Compare 64 contiguous 4-byte values, one bit per value
+ *
+ * Unsigned values are compared by flipping the sign bit of both sides, as
+ * there are only signed integer comparisons.
+ */
+template <typename T>
+std::uint64_t compare_block(
+    const cyanide::byte_t  *data,
+    cyanide::scan_condition condition,
+    T                       value) noexcept
+{
+    constexpr std::size_t lane_size = 4;
+
+    const auto accumulate = [data](auto compare) {
+        std::uint64_t result = 0;
+
+        for (std::size_t i = 0; i < 64 / vector_lanes; ++i)
+        {
+            result |= std::uint64_t{compare(data + i * vector_lanes * lane_size)}
+                   << (i * vector_lanes);
+        }
+
+        return result;
+    };
+
+    if constexpr (std::is_same_v<T, float>)
+    {
+        const vector_f needle = broadcast_f(value);
+
+        switch (condition)
+        {
+            case cyanide::scan_condition::equal:
+                return accumulate([needle](const cyanide::byte_t *block) {
+                    return mask_f(cmpeq_f(load_f(block), needle));
+                });
+
+            case cyanide::scan_condition::not_equal:
+                return accumulate([needle](const cyanide::byte_t *block) {
+                    return mask_f(cmpneq_f(load_f(block), needle));
+                });
+
+            case cyanide::scan_condition::greater:
+                return accumulate([needle](const cyanide::byte_t *block) {
+                    return mask_f(cmpgt_f(load_f(block), needle));
+                });
+
+            case cyanide::scan_condition::less:
+                return accumulate([needle](const cyanide::byte_t *block) {
+                    return mask_f(cmpgt_f(needle, load_f(block)));
+                });
+
+            default:
+                return 0;
+        }
+    }
+    else
+    {
+        const vector_i bias = broadcast_i(
+            std::is_signed_v<T> ? 0 : static_cast<std::int32_t>(0x80000000));
+        const vector_i plain  = broadcast_i(static_cast<std::int32_t>(value));
+        const vector_i needle = xor_i(plain, bias);
+
+        switch (condition)
+        {
+            case cyanide::scan_condition::equal:
+                return accumulate([plain](const cyanide::byte_t *block) {
+                    return mask_i(cmpeq_i(load_i(block), plain));
+                });
+
+            case cyanide::scan_condition::not_equal:
+                return ~accumulate([plain](const cyanide::byte_t *block) {
+                    return mask_i(cmpeq_i(load_i(block), plain));
+                });
+
+            case cyanide::scan_condition::greater:
+                return accumulate([needle, bias](const cyanide::byte_t *block) {
+                    return mask_i(cmpgt_i(xor_i(load_i(block), bias), needle));
+                });
+
+            case cyanide::scan_condition::less:
+                return accumulate([needle, bias](const cyanide::byte_t *block) {
+                    return mask_i(cmpgt_i(needle, xor_i(load_i(block), bias)));
+                });
+
+            default:
+                return 0;
+        }
+    }
+}
+#endif
+
+/*
+ * Compare the values in the slots with the specified value
+ *
+ * @param data Beginning of the first slot.
+ * @param stride Distance between the adjacent slots.
+ * @param slots Number of the slots to compare.
+ * @param condition One of the non-relative conditions.
+ * @param bits Output bitmap, (slots + 63) / 64 words are overwritten.
+ */
+template <typename T>
+void compare_values(
+    const cyanide::byte_t  *data,
+    std::size_t             stride,
+    std::size_t             slots,
+    cyanide::scan_condition condition,
+    T                       value,
+    std::uint64_t          *bits) noexcept
+{
+    std::size_t slot = 0;
+
+#if defined CYANIDE_SIMD_SSE2
+    if constexpr (is_vectorizable_v<T>)
+    {
+        if (stride == sizeof(T))
+        {
+            for (; slot + 64 <= slots; slot += 64)
+            {
+                bits[slot / 64] =
+                    compare_block(data + slot * sizeof(T), condition, value);
+            }
+        }
+    }
+#endif
+
+    for (std::size_t word = slot / 64; word < (slots + 63) / 64; ++word)
+    {
+        std::uint64_t result = 0;
+
+        const std::size_t first = word * 64;
+        const std::size_t last  = std::min(slots, first + 64);
+
+        for (std::size_t current = first; current < last; ++current)
+        {
+            const T current_value =
+                cyanide::safe_pun<T>(data + current * stride);
+
+            if (holds(condition, current_value, value))
+                result |= std::uint64_t{1} << (current - first);
+        }
+
+        bits[word] = result;
+    }
+}
+
+} // namespace cyanide::detail
+
+#endif // !CYANIDE_VALUE_COMPARE_HPP_
@@ -33,6 +33,9 @@ public:
 
     void uninstall()
     {
+        if (!detour_)
+            return;
+
         const bool result = detour_->unHook();
         detour_.reset();
 
@@ -45,6 +48,12 @@ public:
         return reinterpret_cast<void *>(trampoline_);
     }
 
+    // PolyHook writes the trampoline here before the jump to the detour
+    const void *get_trampoline_storage() const noexcept
+    {
+        return &trampoline_;
+    }
+
 protected:
     std::optional<HookT> detour_;
     std::uint64_t        trampoline_ = 0;
@@ -0,0 +1,238 @@
+#ifndef CYANIDE_HOOK_OFFLOAD_HPP_
+#define CYANIDE_HOOK_OFFLOAD_HPP_
+
+#include <cyanide/defs.hpp>
+#include <cyanide/detail/bounded_queue.hpp>
+#include <cyanide/safe_pun.hpp>
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>    // std::memcpy
+#include <functional> // std::function
+#include <memory>     // std::addressof, std::make_shared, std::shared_ptr
+#include <mutex>
+#include <thread> // std::jthread, std::stop_token
+#include <type_traits>
+#include <utility> // std::declval, std::forward, std::index_sequence, std::move
+#include <vector>
+
+namespace cyanide {
+
+// What the hooked call does when the queue can't take the arguments
+enum class offload_policy {
+    drop,  // Skip the callback
+    block, // Wait for a free slot
+    sample // Offload every n-th call once the queue is half full, then drop
+};
+
+// Hooked call waiting for the worker, one cache line at most
+struct offload_task {
+    static constexpr std::size_t max_args_size = 48;
+
+    void (*invoke)(void *callback, const cyanide::byte_t *args) = nullptr;
+    void *callback                                               = nullptr;
+
+    alignas(8) std::array<cyanide::byte_t, max_args_size> args{};
+};
+
+/*
+ * Pool running the observing callbacks off the hooked thread:
+ *
+ *     cyanide::hook_offload offload{2};
+ *
+ *     cyanide::polyhook_x86 hook{
+ *         &some_function,
+ *         offload.observe<decltype(&some_function)>([](int a, float b) {
+ *             // Runs on a worker, some_function may have returned already
+ *         })};
+ *
+ * The hooked call copies its arguments into a preallocated queue slot and
+ * goes on to the original function right away, the callback gets the copies
+ * later. Only trivially copyable arguments can be observed, the references
+ * are copied as the values they refer to. Pointers are copied as is, so the
+ * memory they point to may be gone by the time the callback runs.
+ *
+ * The callbacks may run on several workers at once and must not throw.
+ */
+class hook_offload {
+public:
+    /*
+     * @param workers Number of the worker threads.
+     * @param capacity Calls buffered at most, shared by all the hooks.
+     * @param sample_rate Every which call is offloaded under the sample policy.
+     */
+    explicit hook_offload(
+        std::size_t             workers     = 1,
+        std::size_t             capacity    = 4096,
+        cyanide::offload_policy policy      = cyanide::offload_policy::drop,
+        std::uint32_t           sample_rate = 8);
+
+    // Runs the queued callbacks before returning
+    ~hook_offload();
+
+    hook_offload(const hook_offload &)            = delete;
+    hook_offload &operator=(const hook_offload &) = delete;
+
+    /*
+     * Callback offloading the call and invoking the original function
+     *
+     * @tparam SourceT Pointer to the hooked function type.
+     * @param callback Takes the copies of the arguments, its result is
+     * ignored. Kept alive as long as the pool.
+     */
+    template <typename SourceT, typename CallbackT>
+    [[nodiscard]] auto observe(CallbackT callback)
+    {
+        auto stored = std::make_shared<CallbackT>(std::move(callback));
+
+        {
+            std::lock_guard lock{callbacks_mutex_};
+            callbacks_.push_back(stored);
+        }
+
+        return offloaded_callback<SourceT, CallbackT>{this, stored.get()};
+    }
+
+    // Queue the call according to the policy
+    void submit(const cyanide::offload_task &task);
+
+    // Wait until all the calls queued so far have been handled
+    void wait() const;
+
+    // Number of the calls not offloaded because of the policy
+    [[nodiscard]] std::uint64_t dropped() const noexcept
+    {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+protected:
+    using queue_t = cyanide::detail::bounded_queue<cyanide::offload_task>;
+
+    template <
+        typename SourceT,
+        typename CallbackT,
+        typename = decltype(std::function{std::declval<SourceT>()})>
+    class offloaded_callback;
+
+    template <
+        typename SourceT,
+        typename CallbackT,
+        typename Ret,
+        typename... Args>
+    class offloaded_callback<SourceT, CallbackT, std::function<Ret(Args...)>> {
+        template <typename T>
+        using value_t = std::remove_cvref_t<T>;
+
+        static_assert(
+            (std::is_trivially_copyable_v<value_t<Args>> && ...),
+            "Only trivially copyable arguments can be offloaded");
+
+        // Offsets of the arguments in the task, aligned as in a struct
+        static constexpr auto layout = [] {
+            std::array<std::size_t, sizeof...(Args) + 1> result{};
+            std::size_t                                  offset = 0;
+            std::size_t                                  index  = 0;
+
+            const auto place = [&](std::size_t size, std::size_t alignment) {
+                offset = (offset + alignment - 1) / alignment * alignment;
+
+                result[index++] = offset;
+                offset += size;
+            };
+
+            (place(sizeof(value_t<Args>), alignof(value_t<Args>)), ...);
+
+            // The total size goes last
+            result[index] = offset;
+
+            return result;
+        }();
+
+        static_assert(
+            layout.back() <= cyanide::offload_task::max_args_size,
+            "Arguments don't fit into the offload task");
+
+    public:
+        offloaded_callback(hook_offload *offload, CallbackT *callback)
+            : offload_{offload},
+              callback_{callback}
+        {}
+
+        // By reference, the arguments stay in the frame of the original call
+        Ret operator()(SourceT orig, Args &...args)
+        {
+            cyanide::offload_task task;
+            task.invoke   = &invoke;
+            task.callback = callback_;
+
+            pack(task.args.data(), std::index_sequence_for<Args...>{}, args...);
+
+            offload_->submit(task);
+
+            return orig(std::forward<Args>(args)...);
+        }
+
+    protected:
+        hook_offload *offload_  = nullptr;
+        CallbackT    *callback_ = nullptr;
+
+        template <std::size_t... I>
+        static void pack(
+            cyanide::byte_t *output,
+            std::index_sequence<I...>,
+            const Args &...args)
+        {
+            (std::memcpy(
+                 output + layout[I],
+                 std::addressof(args),
+                 sizeof(value_t<Args>)),
+             ...);
+        }
+
+        template <std::size_t... I>
+        static void unpack(
+            CallbackT             &callback,
+            const cyanide::byte_t *args,
+            std::index_sequence<I...>)
+        {
+            callback(cyanide::safe_pun<value_t<Args>>(args + layout[I])...);
+        }
+
+        static void invoke(void *callback, const cyanide::byte_t *args)
+        {
+            unpack(
+                *static_cast<CallbackT *>(callback),
+                args,
+                std::index_sequence_for<Args...>{});
+        }
+    };
+
+    queue_t                       queue_;
+    const cyanide::offload_policy policy_;
+    const std::uint32_t           sample_rate_;
+
+    std::atomic<std::uint64_t> dropped_      = 0;
+    std::atomic<std::size_t>   completed_    = 0;
+    std::atomic<std::size_t>   idle_workers_ = 0;
+
+    // Calls made under pressure, touched only when the queue is half full
+    std::atomic<std::uint32_t> sample_counter_ = 0;
+
+    std::mutex                         callbacks_mutex_;
+    std::vector<std::shared_ptr<void>> callbacks_;
+
+    std::mutex                  mutex_;
+    std::condition_variable_any wakeup_;
+
+    // Last, stopped before the rest is destroyed
+    std::vector<std::jthread> workers_;
+
+    void run(std::stop_token stop);
+};
+
+} // namespace cyanide
+
+#endif // !CYANIDE_HOOK_OFFLOAD_HPP_
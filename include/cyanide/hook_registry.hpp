@@ -0,0 +1,222 @@
+#ifndef CYANIDE_HOOK_REGISTRY_HPP_
+#define CYANIDE_HOOK_REGISTRY_HPP_
+
+#include <cyanide/code_patch.hpp>
+#include <cyanide/defs.hpp>
+
+#include <concepts> // std::convertible_to
+#include <cstddef>
+#include <cstdint>
+#include <memory> // std::make_shared, std::shared_ptr
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility> // std::forward, std::move
+#include <vector>
+
+namespace cyanide {
+
+namespace types {
+    template <typename T>
+    concept RegistrableHookConcept = requires(T &hook, const T &const_hook)
+    // clang-format off
+    {
+        hook.install();
+        hook.uninstall();
+        { const_hook.source() } -> std::convertible_to<const void *>;
+    };
+    // clang-format on
+} // namespace types
+
+enum class registry_entry_kind : std::uint8_t { hook, patch };
+
+// Snapshot of the registry entry, the name is valid until it's removed
+struct registry_entry {
+    std::uint32_t                id = 0;
+    cyanide::registry_entry_kind kind{};
+    std::uintptr_t               address = 0;
+    std::size_t                  size    = 0;
+    std::string_view             name;
+    bool                         installed = false;
+};
+
+/*
+ * Central owner of the hooks and patches:
+ *
+ *     cyanide::hook_registry registry;
+ *
+ *     registry.emplace<cyanide::polyhook_x86>("a", &func_a, callback_a);
+ *     registry.emplace<cyanide::polyhook_x86>("b", &func_b, callback_b);
+ *     registry.add_patch("c", address, bytes);
+ *
+ *     registry.install_all();
+ *
+ *     if (const auto entry = registry.find(address))
+ *         // entry->name is hooked / patched there
+ *
+ * The entries are kept in columns (structure of arrays) and indexed by a flat
+ * sorted array of the addresses, so the lookups are O(log n) and the bulk
+ * operations walk the contiguous memory. The range of a hook covers the
+ * whole instructions overwritten by the hook_detour_size bytes of its detour,
+ * the entries whose ranges overlap are rejected at registration, before
+ * anything is written.
+ *
+ * The registry is not thread-safe.
+ */
+class hook_registry {
+public:
+    using id_t = std::uint32_t;
+
+    hook_registry() = default;
+    ~hook_registry();
+
+    hook_registry(const hook_registry &)            = delete;
+    hook_registry &operator=(const hook_registry &) = delete;
+
+    /*
+     * Construct the hook, it's not installed until install() / install_all()
+     *
+     * @tparam Hook Hook wrapper template, e.g. cyanide::polyhook_x86.
+     * @param name Name used in the conflict errors and the lookups.
+     *
+     * @throw std::invalid_argument If the hook overlaps with another entry.
+     * @throw std::runtime_error If the instructions at the source can't be
+     * decoded.
+     */
+    template <
+        template <typename...>
+        typename Hook,
+        typename SourceT,
+        typename CallbackT>
+    id_t emplace(std::string name, SourceT source, CallbackT callback)
+    {
+        return add_hook(
+            std::move(name),
+            std::make_shared<Hook<SourceT, CallbackT>>(
+                std::move(source),
+                std::move(callback)));
+    }
+
+    /*
+     * Take over the hook, which must not be installed yet
+     *
+     * @throw std::invalid_argument If the hook overlaps with another entry.
+     * @throw std::runtime_error If the instructions at the source can't be
+     * decoded.
+     */
+    template <cyanide::types::RegistrableHookConcept Hook>
+    id_t add_hook(std::string name, std::shared_ptr<Hook> hook)
+    {
+        static constexpr entry_ops ops{
+            [](void *object) { static_cast<Hook *>(object)->install(); },
+            [](void *object) { static_cast<Hook *>(object)->uninstall(); }};
+
+        const auto address = reinterpret_cast<std::uintptr_t>(
+            static_cast<const void *>(hook->source()));
+
+        // The detour leaves no instruction half-overwritten
+        const std::size_t size = cyanide::instruction_boundary(
+            hook->source(),
+            cyanide::hook_detour_size);
+
+        return add_entry(
+            std::move(name),
+            cyanide::registry_entry_kind::hook,
+            address,
+            size,
+            std::move(hook),
+            &ops);
+    }
+
+    /*
+     * Apply the patch, it's reverted on removal
+     *
+     * @throw std::invalid_argument If the patch overlaps with another entry,
+     * nothing is written then.
+     */
+    id_t add_patch(
+        std::string                      name,
+        void                            *address,
+        std::span<const cyanide::byte_t> bytes,
+        bool                             unprotect = true);
+
+    // Uninstall / revert and destroy the entry, unknown ids are ignored
+    void remove(id_t id);
+
+    void install(id_t id);
+    void uninstall(id_t id);
+
+    /*
+     * Install all the hooks which aren't installed yet, in the address order.
+     * If one of them throws, the ones installed by this call are uninstalled.
+     *
+     * @return Number of the hooks installed.
+     */
+    std::size_t install_all();
+
+    // @return Number of the hooks uninstalled.
+    std::size_t uninstall_all();
+
+    // Entry whose range contains the address
+    [[nodiscard]] std::optional<cyanide::registry_entry>
+    find(const void *address) const;
+
+    [[nodiscard]] std::optional<cyanide::registry_entry> get(id_t id) const;
+
+    // All the entries, ascending by address
+    [[nodiscard]] std::vector<cyanide::registry_entry> entries() const;
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return ids_.size();
+    }
+
+protected:
+    struct entry_ops {
+        void (*install)(void *object);
+        void (*uninstall)(void *object);
+    };
+
+    // Columns, one element per entry
+    std::vector<id_t>                         ids_;
+    std::vector<std::uintptr_t>               addresses_;
+    std::vector<std::uint32_t>                sizes_;
+    std::vector<cyanide::registry_entry_kind> kinds_;
+    std::vector<std::uint8_t>                 installed_;
+    std::vector<std::string>                  names_;
+    std::vector<std::shared_ptr<void>>        objects_;
+    std::vector<const entry_ops *>            ops_; // Null for the patches
+
+    // Sorted by address, points into the columns
+    std::vector<std::uintptr_t> index_addresses_;
+    std::vector<std::uint32_t>  index_slots_;
+
+    std::unordered_map<id_t, std::uint32_t> slots_;
+    id_t                                    next_id_ = 1;
+
+    // Throws if the range overlaps with any entry
+    void check_conflicts(std::uintptr_t address, std::size_t size) const;
+
+    id_t add_entry(
+        std::string                  name,
+        cyanide::registry_entry_kind kind,
+        std::uintptr_t               address,
+        std::size_t                  size,
+        std::shared_ptr<void>        object,
+        const entry_ops             *ops);
+
+    // Position of the first indexed address not less than the given one
+    [[nodiscard]] std::size_t index_position(std::uintptr_t address) const;
+
+    [[nodiscard]] cyanide::registry_entry make_entry(std::uint32_t slot) const;
+
+    [[nodiscard]] std::optional<std::uint32_t> slot_of(id_t id) const;
+
+    void uninstall_slot(std::uint32_t slot);
+};
+
+} // namespace cyanide
+
+#endif // !CYANIDE_HOOK_REGISTRY_HPP_
@@ -0,0 +1,245 @@
+#ifndef CYANIDE_HOOK_TRACER_HPP_
+#define CYANIDE_HOOK_TRACER_HPP_
+
+#include <cyanide/detail/relay.hpp>
+#include <cyanide/detail/spsc_ring.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring> // std::memcpy
+#include <filesystem>
+#include <fstream>
+#include <functional> // std::function
+#include <memory>     // std::addressof, std::shared_ptr
+#include <mutex>
+#include <thread> // std::jthread
+#include <type_traits>
+#include <utility> // std::declval, std::forward, std::move
+#include <vector>
+
+namespace cyanide {
+
+// Single hooked call, 64 bytes in the trace file
+struct trace_event {
+    static constexpr std::size_t max_args = 4;
+
+    std::uint64_t timestamp      = 0; // TSC
+    std::uint64_t return_address = 0;
+    std::uint32_t hook_id        = 0;
+    std::uint32_t thread_id      = 0;
+    std::uint32_t arg_count      = 0;
+    std::uint32_t reserved       = 0;
+
+    // Raw bytes of the arguments up to 8 bytes, addresses of the references,
+    // zeroes for the rest
+    std::array<std::uint64_t, max_args> args{};
+};
+
+static_assert(sizeof(cyanide::trace_event) == 64);
+
+/*
+ * Recorder of the hooked calls into the binary trace file:
+ *
+ *     cyanide::hook_tracer tracer{"calls.trace"};
+ *
+ *     cyanide::polyhook_x86 hook{
+ *         &some_function,
+ *         tracer.trace<decltype(&some_function)>(1)};
+ *
+ * The events are pushed into the ring of the calling thread without locks
+ * or formatting, the background thread drains the rings and writes the
+ * events in batches. The events which don't fit into the full ring are
+ * dropped and counted.
+ *
+ * The file starts with the header (the "CYTR" magic, the format version and
+ * the event size, 4 bytes each), followed by trace_event records as is.
+ */
+class hook_tracer {
+public:
+    static constexpr std::uint32_t magic   = 0x52545943; // "CYTR"
+    static constexpr std::uint32_t version = 1;
+
+    /*
+     * @param path Trace file, overwritten.
+     * @param ring_capacity Events buffered per thread.
+     * @param interval Delay between the writes.
+     *
+     * @throw std::runtime_error If the file can't be opened or the header
+     * written.
+     */
+    explicit hook_tracer(
+        const std::filesystem::path &path,
+        std::size_t                  ring_capacity = 4096,
+        std::chrono::milliseconds    interval = std::chrono::milliseconds{50});
+
+    // Writes the remaining events
+    ~hook_tracer();
+
+    hook_tracer(const hook_tracer &)            = delete;
+    hook_tracer &operator=(const hook_tracer &) = delete;
+
+    /*
+     * Callback recording the call and invoking the original function
+     *
+     * @tparam SourceT Pointer to the hooked function type.
+     * @param hook_id Written into the events as is.
+     */
+    template <typename SourceT>
+    [[nodiscard]] auto trace(std::uint32_t hook_id)
+    {
+        return traced_callback<SourceT, std::nullptr_t>{
+            this,
+            hook_id,
+            nullptr};
+    }
+
+    /*
+     * Callback recording the call and invoking the wrapped one
+     *
+     * @param callback Takes the original function as the first argument.
+     */
+    template <typename SourceT, typename CallbackT>
+    [[nodiscard]] auto trace(std::uint32_t hook_id, CallbackT callback)
+    {
+        return traced_callback<SourceT, CallbackT>{
+            this,
+            hook_id,
+            std::move(callback)};
+    }
+
+    /*
+     * Push the event into the ring of the calling thread, fills the timestamp
+     * and the thread id
+     */
+    void record(cyanide::trace_event event);
+
+    /*
+     * Drain the rings and write the events right away
+     *
+     * @return Number of the events written, zero if the write failed (the
+     * events are counted in dropped() then).
+     */
+    std::size_t flush();
+
+    // Number of the events that didn't fit into the rings or failed to be
+    // written
+    [[nodiscard]] std::uint64_t dropped() const;
+
+    // Number of the rings, one per thread that has recorded into the tracer.
+    // The ones of the exited threads are counted until the next flush.
+    [[nodiscard]] std::size_t ring_count() const;
+
+protected:
+    using ring_t = cyanide::detail::spsc_ring<cyanide::trace_event>;
+
+    struct thread_ring {
+        explicit thread_ring(std::size_t capacity) : ring{capacity} {}
+
+        ring_t                     ring;
+        std::atomic<std::uint64_t> dropped = 0;
+    };
+
+    template <
+        typename SourceT,
+        typename CallbackT,
+        typename = decltype(std::function{std::declval<SourceT>()})>
+    class traced_callback;
+
+    template <
+        typename SourceT,
+        typename CallbackT,
+        typename Ret,
+        typename... Args>
+    class traced_callback<SourceT, CallbackT, std::function<Ret(Args...)>> {
+    public:
+        traced_callback(
+            hook_tracer  *tracer,
+            std::uint32_t hook_id,
+            CallbackT     callback)
+            : tracer_{tracer},
+              hook_id_{hook_id},
+              callback_{std::move(callback)}
+        {}
+
+        // By reference, the arguments stay in the frame of the original call
+        Ret operator()(SourceT orig, Args &...args)
+        {
+            cyanide::trace_event event;
+
+            // Read first, the callback may call the other hooks
+            event.return_address = cyanide::detail::hook_return_address;
+            event.hook_id        = hook_id_;
+            event.arg_count      = static_cast<std::uint32_t>(sizeof...(Args));
+
+            std::size_t index = 0;
+            (store_arg<Args>(event, index++, args), ...);
+
+            tracer_->record(event);
+
+            if constexpr (std::is_null_pointer_v<CallbackT>)
+                return orig(std::forward<Args>(args)...);
+            else
+                return callback_(orig, std::forward<Args>(args)...);
+        }
+
+    protected:
+        hook_tracer  *tracer_  = nullptr;
+        std::uint32_t hook_id_ = 0;
+        CallbackT     callback_;
+
+        template <typename Arg, typename T>
+        static void store_arg(
+            cyanide::trace_event &event,
+            std::size_t           index,
+            const T              &value)
+        {
+            if (index >= cyanide::trace_event::max_args)
+                return;
+
+            std::uint64_t &stored = event.args[index];
+
+            if constexpr (std::is_reference_v<Arg>)
+            {
+                stored =
+                    reinterpret_cast<std::uintptr_t>(std::addressof(value));
+            }
+            else if constexpr (
+                std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(stored))
+            {
+                std::memcpy(&stored, std::addressof(value), sizeof(T));
+            }
+        }
+    };
+
+    std::size_t               ring_capacity_;
+    std::chrono::milliseconds interval_;
+
+    // Tells apart the tracers allocated at the same address
+    const std::uint64_t generation_;
+
+    // Guards the ring list, taken by the producers on their first event only
+    mutable std::mutex                        mutex_;
+    std::vector<std::shared_ptr<thread_ring>> rings_;
+    std::uint64_t                             retired_dropped_ = 0;
+    std::uint64_t                             unwritten_       = 0;
+
+    // Serializes the flushes
+    std::mutex                        flush_mutex_;
+    std::vector<cyanide::trace_event> batch_;
+    std::ofstream                     file_;
+
+    std::condition_variable_any wakeup_;
+    std::jthread                thread_;
+
+    thread_ring &current_ring();
+
+    void run(std::stop_token stop);
+};
+
+} // namespace cyanide
+
+#endif // !CYANIDE_HOOK_TRACER_HPP_
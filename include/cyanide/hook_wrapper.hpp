@@ -3,17 +3,29 @@
 
 #include <cyanide/defs.hpp>
 #include <cyanide/detail/relay.hpp>
+#include <cyanide/detail/thread_state.hpp>
+#include <cyanide/detail/thunk_template.hpp>
 #include <cyanide/function_traits.hpp>
+#include <cyanide/process_memory.hpp>
 
-#include <xbyak/xbyak.h>
+#if defined CYANIDE_HOOK_JIT
+    #include <xbyak/xbyak.h>
+#endif
 
+#include <algorithm> // std::copy_n, std::max, std::min, std::sort
+#include <atomic>    // std::atomic_ref
 #include <concepts>
 #include <cstddef>
 #include <cstdint>
+#include <cstring> // std::memcpy
 #include <functional>
+#include <intrin.h> // __rdtsc
+#include <limits>
 #include <memory>
+#include <stdexcept>
 #include <type_traits>
 #include <utility> // std::exchange, std::forward, std::move, std::swap
+#include <vector>
 
 namespace cyanide {
 
@@ -30,6 +42,11 @@ namespace types {
         // Enable clang format when concepts will be handled properly
         // clang-format off
         { hook_impl.get_trampoline() } -> std::convertible_to<void *>;
+
+        // Where the trampoline address is stored (at least its low 32 bits),
+        // filled in before the hook is enabled
+        { hook_impl.get_trampoline_storage() }
+            -> std::convertible_to<const void *>;
         // clang-format on
     };
 } // namespace types
@@ -44,6 +61,9 @@ class hook_wrapper {
     friend struct cyanide::detail::relay<this_t, SourceT>;
 
 public:
+    // Keeps the calling thread from entering the callback while alive
+    using bypass_guard = cyanide::detail::depth_guard;
+
     template <typename... HookArgs>
     hook_wrapper(SourceT source, CallbackT callback, HookArgs &&...hook_args)
         : source_{reinterpret_cast<cyanide::byte_t *>(source)},
@@ -55,12 +75,22 @@ public:
 
         hook_impl_ =
             std::make_unique<HookT>(std::forward<HookArgs>(hook_args)...);
-        code_gen_ = std::make_unique<Xbyak::CodeGenerator>();
     }
 
     ~hook_wrapper()
     {
-        hook_impl_->uninstall();
+        // The object seems to be moved-from
+        if (!hook_impl_)
+            return;
+
+        if (installed_)
+            hook_impl_->uninstall();
+
+        if (thread_slot_ != no_thread_slot)
+            cyanide::detail::thread_state::release_slot(thread_slot_);
+
+        if (prebuilt_thunk_)
+            cyanide::detail::thunk_arena::release(prebuilt_thunk_);
     }
 
     hook_wrapper(const hook_wrapper &)            = delete;
@@ -69,9 +99,19 @@ public:
     hook_wrapper(hook_wrapper &&other)
         : source_{std::exchange(other.source_, nullptr)},
           relay_jump_{std::exchange(other.relay_jump_, nullptr)},
+          thread_slot_{std::exchange(other.thread_slot_, no_thread_slot)},
+          guard_reentrancy_{std::exchange(other.guard_reentrancy_, false)},
+          installed_{std::exchange(other.installed_, false)},
+          caller_ranges_{std::move(other.caller_ranges_)},
+          sample_period_{std::exchange(other.sample_period_, 0)},
+          rate_interval_{std::exchange(other.rate_interval_, 0)},
+          next_tsc_{std::exchange(other.next_tsc_, 0)},
           callback_{std::move(other.callback_)},
           hook_impl_{std::move(other.hook_impl_)},
-          code_gen_{std::move(other.code_gen_)}
+#if defined CYANIDE_HOOK_JIT
+          code_gen_{std::move(other.code_gen_)},
+#endif
+          prebuilt_thunk_{std::exchange(other.prebuilt_thunk_, nullptr)}
     {}
 
     hook_wrapper &operator=(hook_wrapper &&other)
@@ -95,10 +135,20 @@ public:
         using std::swap;
 
         swap(lhs.source_, rhs.source_);
-        swap(lhs.relay_, lhs.relay_);
+        swap(lhs.relay_jump_, rhs.relay_jump_);
+        swap(lhs.thread_slot_, rhs.thread_slot_);
+        swap(lhs.guard_reentrancy_, rhs.guard_reentrancy_);
+        swap(lhs.installed_, rhs.installed_);
+        swap(lhs.caller_ranges_, rhs.caller_ranges_);
+        swap(lhs.sample_period_, rhs.sample_period_);
+        swap(lhs.rate_interval_, rhs.rate_interval_);
+        swap(lhs.next_tsc_, rhs.next_tsc_);
         swap(lhs.callback_, rhs.callback_);
         swap(lhs.hook_impl_, rhs.hook_impl_);
+#if defined CYANIDE_HOOK_JIT
         swap(lhs.code_gen_, rhs.code_gen_);
+#endif
+        swap(lhs.prebuilt_thunk_, rhs.prebuilt_thunk_);
     }
 
     void install()
@@ -107,11 +157,15 @@ public:
             relay_jump_ = make_relay_jump();
 
         hook_impl_->install(source_, relay_jump_);
+        installed_ = true;
     }
 
+    // Does nothing if the hook isn't installed
     void uninstall()
     {
-        hook_impl_->uninstall();
+        // Cleared first, the implementation drops the hook even if it throws
+        if (std::exchange(installed_, false))
+            hook_impl_->uninstall();
     }
 
     void *get_trampoline()
@@ -119,10 +173,154 @@ public:
         return hook_impl_->get_trampoline();
     }
 
+    [[nodiscard]] void *source() const noexcept
+    {
+        return source_;
+    }
+
+    /*
+     * Make the calls from within the callback (on the same thread) go
+     * straight to the original function. The check is done in the thunk, so
+     * it costs a couple of instructions per call.
+     *
+     * Must be called before the first install().
+     */
+    void guard_reentrancy()
+    {
+        ensure_not_generated();
+        ensure_thread_slot();
+
+        guard_reentrancy_ = true;
+    }
+
+    /*
+     * Enter the callback on every Nth call of each thread (the first one
+     * included), the rest of the calls go straight to the original function.
+     * The countdown is kept per thread and checked in the thunk.
+     *
+     * Must be called before the first install().
+     *
+     * @param period Calls per callback invocation, 1 disables the sampling.
+     *
+     * @throw std::invalid_argument If the period is zero.
+     */
+    void sample_every(std::uint32_t period)
+    {
+        ensure_not_generated();
+
+        if (period == 0)
+            throw std::invalid_argument{"Sampling period must not be zero"};
+
+        if (period > 1)
+            ensure_thread_slot();
+
+        sample_period_ = period > 1 ? period : 0;
+    }
+
+    /*
+     * Enter the callback at most once per the interval, the rest of the calls
+     * go straight to the original function. The timestamp counter is checked
+     * in the thunk, the limit is shared between the threads and approximate,
+     * i.e. the threads racing for the same interval may all enter.
+     *
+     * Must be called before the first install().
+     *
+     * @param interval_ticks Minimal number of TSC ticks between the callback
+     * invocations, 0 disables the limit.
+     */
+    void limit_rate(std::uint64_t interval_ticks)
+    {
+        ensure_not_generated();
+
+        rate_interval_ = interval_ticks;
+    }
+
+    /*
+     * Enter the callback only when called from within the ranges, e.g. the
+     * module of interest. The rest of the calls go straight to the original
+     * function, the return address is checked in the thunk.
+     *
+     * Must be called before the first install().
+     *
+     * @param ranges Ranges of the caller addresses, may overlap.
+     */
+    void filter_callers(std::vector<cyanide::memory_region> ranges)
+    {
+        ensure_not_generated();
+
+        std::sort(
+            ranges.begin(),
+            ranges.end(),
+            [](const auto &lhs, const auto &rhs) {
+                return lhs.base < rhs.base;
+            });
+
+        // Merge the overlapping ones, so that the thunk can stop at the first
+        // range above the address
+        caller_ranges_.clear();
+
+        for (const auto &range : ranges)
+        {
+            if (range.size == 0)
+                continue;
+
+            if (!caller_ranges_.empty()
+                && range.base - caller_ranges_.back().base
+                       <= caller_ranges_.back().size)
+            {
+                auto &last = caller_ranges_.back();
+
+                // The end may not fit into the address
+                const std::uint64_t end = std::max(
+                    std::uint64_t{last.base} + last.size,
+                    std::uint64_t{range.base} + range.size);
+
+                last.size = static_cast<std::size_t>(std::min<std::uint64_t>(
+                    end - last.base,
+                    std::numeric_limits<std::size_t>::max()));
+            }
+            else
+            {
+                caller_ranges_.push_back(range);
+            }
+        }
+    }
+
+    /*
+     * Let the calls made by the current thread go straight to the original
+     * function while the returned guard is alive. Requires the reentrancy
+     * guard to be enabled.
+     */
+    [[nodiscard]] bypass_guard bypass()
+    {
+        if (!guard_reentrancy_)
+            throw std::logic_error{"Reentrancy guard is not enabled"};
+
+        return bypass_guard{
+            &cyanide::detail::thread_state::current()[thread_slot_]};
+    }
+
 protected:
+    static constexpr std::size_t no_thread_slot = static_cast<std::size_t>(-1);
+
     cyanide::byte_t       *source_     = nullptr;
     const cyanide::byte_t *relay_jump_ = nullptr;
 
+    std::size_t thread_slot_      = no_thread_slot;
+    bool        guard_reentrancy_ = false;
+    bool        installed_        = false;
+
+    // Sorted and non-overlapping, empty if any caller is accepted
+    std::vector<cyanide::memory_region> caller_ranges_;
+
+    // Zero if the callback isn't sampled / rate limited
+    std::uint32_t sample_period_ = 0;
+    std::uint64_t rate_interval_ = 0;
+
+    // Timestamp the callback may be entered at, read by the thunk
+    alignas(std::atomic_ref<std::uint64_t>::required_alignment)
+        std::uint64_t next_tsc_ = 0;
+
     /*
      * There are 2 ways to retrieve the CallbackT signature - by decomposing it
      * via type traits, and by simulating the initialization of std::function.
@@ -143,11 +341,64 @@ protected:
      */
     decltype(std::function{std::declval<CallbackT>()}) callback_;
 
-    std::unique_ptr<HookT>                hook_impl_;
+    std::unique_ptr<HookT> hook_impl_;
+
+#if defined CYANIDE_HOOK_JIT
     std::unique_ptr<Xbyak::CodeGenerator> code_gen_;
+#endif
+
+    // Thunk copied from the template, null if it's generated
+    cyanide::byte_t *prebuilt_thunk_ = nullptr;
+
+    [[nodiscard]] bool has_thunk_options() const noexcept
+    {
+        return guard_reentrancy_ || sample_period_ != 0 || rate_interval_ != 0
+            || !caller_ranges_.empty();
+    }
 
     const cyanide::byte_t *make_relay_jump()
     {
+        if (!has_thunk_options())
+            return make_prebuilt_thunk();
+
+#if defined CYANIDE_HOOK_JIT
+        return generate_relay_jump();
+#else
+        throw std::logic_error{"Thunk options require CYANIDE_HOOK_JIT"};
+#endif
+    }
+
+    // Copy the template and patch the wrapper and relay addresses in
+    const cyanide::byte_t *make_prebuilt_thunk()
+    {
+        constexpr const auto &thunk = detail::thunk_template_v<SourceT>;
+
+        cyanide::byte_t *code = detail::thunk_arena::allocate();
+        std::copy_n(thunk.code.data(), thunk.size, code);
+
+        const auto wrapper  = reinterpret_cast<std::uintptr_t>(this);
+        const auto relay    = reinterpret_cast<std::uintptr_t>(
+            &detail::relay<this_t, SourceT>::func);
+        const auto relative = static_cast<std::uint32_t>(
+            relay - reinterpret_cast<std::uintptr_t>(
+                        code + thunk.relay_offset + 4));
+
+        std::memcpy(code + thunk.wrapper_offset, &wrapper, 4);
+        std::memcpy(code + thunk.relay_offset, &relative, 4);
+
+        detail::thunk_arena::commit(code);
+
+        prebuilt_thunk_ = code;
+
+        return code;
+    }
+
+#if defined CYANIDE_HOOK_JIT
+    const cyanide::byte_t *generate_relay_jump()
+    {
+        if (!code_gen_)
+            code_gen_ = std::make_unique<Xbyak::CodeGenerator>();
+
         using namespace Xbyak::util;
         using namespace cyanide::types;
 
@@ -160,6 +411,19 @@ protected:
 
         code_gen_->reset();
 
+        Xbyak::Label to_trampoline;
+
+        // Nothing is touched on the stack yet, so the original can be entered
+        // as is. eax is a scratch register in every convention.
+        if (!caller_ranges_.empty())
+            filter_return_address(to_trampoline);
+
+        if (guard_reentrancy_ || sample_period_ != 0)
+            check_thread_state(to_trampoline);
+
+        if (rate_interval_ != 0)
+            check_rate(to_trampoline);
+
         /*
          * Explaining the speciality of cdecl case
          *
@@ -177,8 +441,8 @@ protected:
          * (original code has no clue about hook object, right?), that's why
          * we can't just return to the original. Instead, we don't do
          * anything with original return address and pushing our own one.
-         * That's explains why we have unused `return_addr` parameter in
-         * cdecl thunk - original address is treated as an argument.
+         * That's explains why we have `return_addr` parameter in cdecl
+         * relay - original address is treated as an argument.
          *
          * In other conventions the stack is cleaned up by the callee (i.e.
          * the called function), which is aware of additional "hook object"
@@ -240,25 +504,222 @@ protected:
             code_gen_->jmp(&detail::relay<this_t, SourceT>::func);
         }
 
+        /*
+         * Only generated with the options, some of them skip the callback.
+         * The address is read from the implementation's own storage, which
+         * is filled in before the detour is written, so a call racing with
+         * install() never sees it unset (or left from the previous install).
+         */
+        code_gen_->L(to_trampoline);
+        code_gen_->jmp(ptr[hook_impl_->get_trampoline_storage()]);
+
         return code_gen_->getCode();
     }
 
-    template <typename Ret, typename... Args>
+    // Load the thread block pointer into eax, jump to the label if it's null
+    void load_thread_block(Xbyak::Label &no_block)
+    {
+        using namespace Xbyak::util;
+        using detail::thread_state;
+
+        const std::size_t index = thread_state::tls_index();
+
+        if (index < thread_state::tls_minimum_available)
+        {
+            code_gen_->putSeg(fs);
+            code_gen_->mov(eax, ptr[thread_state::teb_tls_slots + index * 4]);
+        }
+        else
+        {
+            code_gen_->putSeg(fs);
+            code_gen_->mov(eax, ptr[thread_state::teb_tls_expansion_slots]);
+            code_gen_->test(eax, eax);
+            code_gen_->jz(no_block, Xbyak::CodeGenerator::T_NEAR);
+
+            code_gen_->mov(
+                eax,
+                ptr[eax
+                    + (index - thread_state::tls_minimum_available) * 4]);
+        }
+
+        code_gen_->test(eax, eax);
+        code_gen_->jz(no_block, Xbyak::CodeGenerator::T_NEAR);
+    }
+
+    // Jump to the label if the thread is inside the callback or skips the call
+    void check_thread_state(Xbyak::Label &skip)
+    {
+        using namespace Xbyak::util;
+        using detail::hook_thread_state;
+
+        Xbyak::Label enter;
+
+        // No block means all-zero state, i.e. the call is not skipped
+        load_thread_block(enter);
+
+        const std::size_t state_offset =
+            thread_slot_ * sizeof(hook_thread_state);
+
+        if (guard_reentrancy_)
+        {
+            code_gen_->cmp(
+                dword[eax + state_offset + offsetof(hook_thread_state, depth)],
+                0);
+            code_gen_->jne(skip, Xbyak::CodeGenerator::T_NEAR);
+        }
+
+        if (sample_period_ != 0)
+        {
+            const auto countdown = dword
+                [eax + state_offset + offsetof(hook_thread_state, countdown)];
+
+            // Reset by the relay once the callback is entered
+            code_gen_->cmp(countdown, 0);
+            code_gen_->je(enter, Xbyak::CodeGenerator::T_NEAR);
+            code_gen_->dec(countdown);
+            code_gen_->jmp(skip, Xbyak::CodeGenerator::T_NEAR);
+        }
+
+        code_gen_->L(enter);
+    }
+
+    // Jump to the label if the timestamp is below next_tsc_
+    void check_rate(Xbyak::Label &skip)
+    {
+        using namespace Xbyak::util;
+
+        Xbyak::Label enter;
+        Xbyak::Label too_early;
+
+        const auto *next_tsc = reinterpret_cast<const std::uint32_t *>(
+            &next_tsc_);
+
+        // edx holds an argument in fastcall
+        code_gen_->push(edx);
+        code_gen_->rdtsc();
+
+        // 64-bit comparison of edx:eax with next_tsc_
+        code_gen_->cmp(edx, dword[next_tsc + 1]);
+        code_gen_->jb(too_early);
+        code_gen_->ja(enter);
+        code_gen_->cmp(eax, dword[next_tsc]);
+        code_gen_->jae(enter);
+
+        code_gen_->L(too_early);
+        code_gen_->pop(edx);
+        code_gen_->jmp(skip, Xbyak::CodeGenerator::T_NEAR);
+
+        code_gen_->L(enter);
+        code_gen_->pop(edx);
+    }
+
+    // Jump to the label unless the return address is within caller_ranges_
+    void filter_return_address(Xbyak::Label &mismatch)
+    {
+        using namespace Xbyak::util;
+
+        Xbyak::Label match;
+
+        code_gen_->mov(eax, ptr[esp]);
+
+        // The ranges are ascending, so the address below the current one is
+        // below all the rest as well
+        for (const auto &range : caller_ranges_)
+        {
+            const std::uint64_t end =
+                std::uint64_t{range.base} + std::uint64_t{range.size};
+
+            code_gen_->cmp(eax, static_cast<std::uint32_t>(range.base));
+            code_gen_->jb(mismatch, Xbyak::CodeGenerator::T_NEAR);
+
+            // Reaches the top of the address space
+            if (end > 0xFFFFFFFF)
+            {
+                code_gen_->jmp(match, Xbyak::CodeGenerator::T_NEAR);
+                break;
+            }
+
+            code_gen_->cmp(eax, static_cast<std::uint32_t>(end));
+            code_gen_->jb(match, Xbyak::CodeGenerator::T_NEAR);
+        }
+
+        code_gen_->jmp(mismatch, Xbyak::CodeGenerator::T_NEAR);
+        code_gen_->L(match);
+    }
+#endif
+
+    /*
+     * Called by the relay before the callback, returns the guard for the
+     * callback duration
+     */
+    [[nodiscard]] detail::depth_guard enter_callback()
+    {
+        if (rate_interval_ != 0)
+        {
+            std::atomic_ref{next_tsc_}.store(
+                __rdtsc() + rate_interval_,
+                std::memory_order_relaxed);
+        }
+
+        if (thread_slot_ == no_thread_slot)
+            return detail::depth_guard{nullptr};
+
+        detail::hook_thread_state &state =
+            detail::thread_state::current()[thread_slot_];
+
+        if (sample_period_ != 0)
+            state.countdown = sample_period_ - 1;
+
+        return detail::depth_guard{guard_reentrancy_ ? &state : nullptr};
+    }
+
+    void ensure_thread_slot()
+    {
+        if (thread_slot_ == no_thread_slot)
+            thread_slot_ = detail::thread_state::acquire_slot();
+    }
+
+    void ensure_not_generated() const
+    {
+        if (relay_jump_)
+        {
+            throw std::logic_error{
+                "Thunk options must be set before the first install"};
+        }
+    }
+
+    /*
+     * The arguments are the parameters of the relay, i.e. they are the ones
+     * the original caller has put on the stack. They are passed to the
+     * callback by reference if it takes them so, the by-value parameters are
+     * moved from them, nothing is copied.
+     */
+    template <typename Ret, typename... CallbackArgs, typename... Args>
     static Ret callback_dispatcher(
-        SourceT                               source,
-        std::function<Ret(SourceT, Args...)> &callback,
-        Args &&...args)
+        SourceT                                       source,
+        std::function<Ret(SourceT, CallbackArgs...)> &callback,
+        Args &...args)
     {
-        return callback(source, std::forward<Args>(args)...);
+        return callback(source, pass_argument<CallbackArgs>(args)...);
     }
 
-    template <typename Ret, typename... Args>
+    template <typename Ret, typename... CallbackArgs, typename... Args>
     static Ret callback_dispatcher(
-        SourceT                      source,
-        std::function<Ret(Args...)> &callback,
-        Args &&...args)
+        SourceT                              source,
+        std::function<Ret(CallbackArgs...)> &callback,
+        Args &...args)
     {
-        return callback(std::forward<Args>(args)...);
+        return callback(pass_argument<CallbackArgs>(args)...);
+    }
+
+    // Lvalue for the reference parameter, rvalue for the by-value one
+    template <typename Param, typename Arg>
+    static constexpr auto &&pass_argument(Arg &arg) noexcept
+    {
+        if constexpr (std::is_lvalue_reference_v<Param>)
+            return arg;
+        else
+            return std::move(arg);
     }
 };
 
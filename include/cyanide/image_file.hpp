@@ -0,0 +1,80 @@
+#ifndef CYANIDE_IMAGE_FILE_HPP_
+#define CYANIDE_IMAGE_FILE_HPP_
+
+#include <cyanide/defs.hpp>
+#include <cyanide/signature.hpp>
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace cyanide {
+
+enum class image_format { pe, elf };
+
+/*
+ * Executable image on disk (PE or ELF), parsed just enough to map its sections
+ * to virtual addresses. Nothing is loaded or relocated, so signatures can be
+ * resolved to RVAs without running the binary, e.g. in a build pipeline.
+ *
+ * The image doesn't own the data - typically it's a cyanide::mapped_file,
+ * which must outlive the image.
+ */
+class image_file {
+public:
+    struct section {
+        std::string                      name;
+        std::uint64_t                    rva = 0;
+        std::span<const cyanide::byte_t> data;
+    };
+
+    /*
+     * @param image Raw contents of the file.
+     *
+     * @throw std::runtime_error If the image is neither PE nor ELF or it is
+     * malformed.
+     */
+    explicit image_file(std::span<const cyanide::byte_t> image);
+
+    [[nodiscard]] cyanide::image_format format() const noexcept
+    {
+        return format_;
+    }
+
+    // Preferred load address, RVAs are relative to it
+    [[nodiscard]] std::uint64_t image_base() const noexcept
+    {
+        return image_base_;
+    }
+
+    [[nodiscard]] const std::vector<section> &sections() const noexcept
+    {
+        return sections_;
+    }
+
+    // Translate the offset in the file to RVA, if it belongs to some section
+    [[nodiscard]] std::optional<std::uint64_t>
+    offset_to_rva(std::uint64_t file_offset) const noexcept;
+
+    // Matches crossing the section boundary are not reported
+    [[nodiscard]] std::optional<std::uint64_t>
+    find_pattern(const cyanide::signature &sig) const;
+
+    [[nodiscard]] std::vector<std::uint64_t>
+    find_all_patterns(const cyanide::signature &sig) const;
+
+protected:
+    std::span<const cyanide::byte_t> image_;
+    cyanide::image_format            format_     = cyanide::image_format::pe;
+    std::uint64_t                    image_base_ = 0;
+    std::vector<section>             sections_;
+
+    void parse_pe();
+    void parse_elf();
+};
+
+} // namespace cyanide
+
+#endif // !CYANIDE_IMAGE_FILE_HPP_
@@ -0,0 +1,25 @@
+#ifndef CYANIDE_INSTRUCTION_LENGTH_HPP_
+#define CYANIDE_INSTRUCTION_LENGTH_HPP_
+
+#include <cyanide/defs.hpp>
+
+#include <cstddef>
+#include <span>
+
+namespace cyanide {
+
+/*
+ * Length of the 32-bit x86 instruction at the start of the code. Only the
+ * length is decoded (prefixes, opcode, ModRM, SIB, displacement and
+ * immediate), the operands are not. VEX and EVEX encoded instructions are
+ * supported.
+ *
+ * @return Length in bytes, zero if the code is truncated or the instruction
+ * is longer than the architectural limit of 15 bytes.
+ */
+[[nodiscard]] std::size_t
+instruction_length(std::span<const cyanide::byte_t> code) noexcept;
+
+} // namespace cyanide
+
+#endif // !CYANIDE_INSTRUCTION_LENGTH_HPP_
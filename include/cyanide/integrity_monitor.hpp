@@ -0,0 +1,179 @@
+#ifndef CYANIDE_INTEGRITY_MONITOR_HPP_
+#define CYANIDE_INTEGRITY_MONITOR_HPP_
+
+#include <cyanide/defs.hpp>
+#include <cyanide/patch.hpp>
+
+#include <chrono>
+#include <concepts> // std::convertible_to
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional> // std::function
+#include <map>
+#include <mutex>
+#include <thread> // std::jthread
+#include <unordered_map>
+#include <vector>
+
+namespace cyanide {
+
+namespace types {
+    template <typename T>
+    concept HookSourceConcept = requires(const T &hook)
+    // clang-format off
+    {
+        { hook.source() } -> std::convertible_to<const void *>;
+    };
+    // clang-format on
+} // namespace types
+
+// Watched range that doesn't hold the expected bytes anymore
+struct integrity_violation {
+    std::uintptr_t               address = 0;
+    std::vector<cyanide::byte_t> expected;
+};
+
+/*
+ * Background verifier of the patched code:
+ *
+ *     cyanide::integrity_monitor monitor{[](const auto &violation) {
+ *         // Somebody has overwritten violation.address
+ *     }};
+ *
+ *     auto patch_watch = monitor.watch(some_patch);
+ *     auto hook_watch  = monitor.watch(some_hook);
+ *
+ * The watched ranges are grouped by page, every page has a single CRC32C
+ * checksum of the expected bytes of all its ranges, so a check pass hashes
+ * only the watched bytes and compares them one by one only on the pages
+ * whose checksum differs. The checks run on a thread of the lowest priority.
+ *
+ * The callback is called from the monitor thread once per divergence, i.e.
+ * after the range is restored it's reported again on the next overwrite. The
+ * watched memory must stay mapped while it's watched, the handles must not
+ * outlive the monitor.
+ */
+class integrity_monitor {
+public:
+    using callback_t =
+        std::function<void(const cyanide::integrity_violation &)>;
+
+    static constexpr std::size_t hook_detour_size = cyanide::hook_detour_size;
+
+    // Unwatches the range on destruction
+    class watch_handle {
+    public:
+        watch_handle() = default;
+        ~watch_handle();
+
+        watch_handle(const watch_handle &)            = delete;
+        watch_handle &operator=(const watch_handle &) = delete;
+
+        watch_handle(watch_handle &&other) noexcept;
+        watch_handle &operator=(watch_handle &&other) noexcept;
+
+        friend void swap(watch_handle &lhs, watch_handle &rhs) noexcept;
+
+    protected:
+        friend class integrity_monitor;
+
+        watch_handle(integrity_monitor *monitor, std::uint64_t id) noexcept;
+
+        integrity_monitor *monitor_ = nullptr;
+        std::uint64_t      id_      = 0;
+    };
+
+    /*
+     * @param on_violation Called from the monitor thread, must not throw.
+     * @param interval Delay between the check passes.
+     */
+    explicit integrity_monitor(
+        callback_t                on_violation,
+        std::chrono::milliseconds interval = std::chrono::milliseconds{100});
+
+    ~integrity_monitor();
+
+    integrity_monitor(const integrity_monitor &)            = delete;
+    integrity_monitor &operator=(const integrity_monitor &) = delete;
+
+    /*
+     * Watch the range, its current contents are the expected ones
+     *
+     * @param address Beginning of the range.
+     * @param size Size of the range.
+     */
+    [[nodiscard]] watch_handle watch(const void *address, std::size_t size);
+
+    // Watch the patched bytes, the patch must be already applied
+    template <typename Storage>
+    [[nodiscard]] watch_handle watch(const cyanide::patch<Storage> &target)
+    {
+        return watch(target.address(), target.size());
+    }
+
+    /*
+     * Watch the hook detour, the hook must be already installed. The NOPs
+     * which fill the rest of the last overwritten instruction are watched
+     * too.
+     *
+     * @throw std::runtime_error If the detour can't be decoded.
+     */
+    template <cyanide::types::HookSourceConcept Hook>
+    [[nodiscard]] watch_handle watch(const Hook &hook)
+    {
+        return watch(hook.source(), detour_size(hook.source()));
+    }
+
+    /*
+     * Run a check pass right away on the calling thread
+     *
+     * @return Number of the new violations.
+     */
+    std::size_t check();
+
+    [[nodiscard]] std::size_t size() const;
+
+protected:
+    struct site {
+        std::uintptr_t               address = 0;
+        std::vector<cyanide::byte_t> expected;
+        bool                         violated = false;
+    };
+
+    // Part of a site that lies within a single page
+    struct site_part {
+        std::uint64_t  id      = 0;
+        std::uintptr_t address = 0;
+        std::size_t    size    = 0;
+        std::size_t    offset  = 0; // Offset in the expected bytes of the site
+    };
+
+    struct page {
+        std::vector<site_part> parts;
+        std::uint32_t          checksum = 0;
+        bool                   diverged = false;
+    };
+
+    callback_t                              on_violation_;
+    std::chrono::milliseconds               interval_;
+    mutable std::mutex                      mutex_;
+    std::condition_variable_any             wakeup_;
+    std::unordered_map<std::uint64_t, site> sites_;
+    std::map<std::uintptr_t, page>          pages_;
+    std::uint64_t                           next_id_ = 1;
+    std::jthread                            thread_;
+
+    void unwatch(std::uint64_t id);
+
+    // Size of the installed detour along with the NOPs following it
+    [[nodiscard]] static std::size_t detour_size(const void *source);
+
+    void update_checksum(page &current) const;
+
+    void run(std::stop_token stop);
+};
+
+} // namespace cyanide
+
+#endif // !CYANIDE_INTEGRITY_MONITOR_HPP_
@@ -0,0 +1,43 @@
+#ifndef CYANIDE_MAPPED_FILE_HPP_
+#define CYANIDE_MAPPED_FILE_HPP_
+
+#include <cyanide/defs.hpp>
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace cyanide {
+
+/*
+ * Read-only memory mapping of the whole file. The contents are paged in by the
+ * OS on access, nothing is copied.
+ */
+class mapped_file {
+public:
+    explicit mapped_file(const std::filesystem::path &path);
+    ~mapped_file();
+
+    mapped_file(const mapped_file &)            = delete;
+    mapped_file &operator=(const mapped_file &) = delete;
+
+    mapped_file(mapped_file &&other) noexcept;
+    mapped_file &operator=(mapped_file &&other) noexcept;
+
+    friend void swap(mapped_file &lhs, mapped_file &rhs) noexcept;
+
+    [[nodiscard]] std::span<const cyanide::byte_t> data() const noexcept
+    {
+        return {view_, size_};
+    }
+
+protected:
+    void                  *file_    = nullptr;
+    void                  *mapping_ = nullptr;
+    const cyanide::byte_t *view_    = nullptr;
+    std::size_t            size_    = 0;
+};
+
+} // namespace cyanide
+
+#endif // !CYANIDE_MAPPED_FILE_HPP_
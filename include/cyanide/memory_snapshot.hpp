@@ -0,0 +1,298 @@
+#ifndef CYANIDE_MEMORY_SNAPSHOT_HPP_
+#define CYANIDE_MEMORY_SNAPSHOT_HPP_
+
+#include <cyanide/defs.hpp>
+#include <cyanide/detail/crc32c.hpp>
+#include <cyanide/process_memory.hpp>
+#include <cyanide/safe_pun.hpp>
+
+#include <algorithm> // std::min, std::sort, std::unique, std::upper_bound
+#include <cstddef>
+#include <cstdint>
+#include <iterator> // std::prev
+#include <span>
+#include <vector>
+
+namespace cyanide {
+
+// Range of bytes that differs between two snapshots
+struct memory_diff {
+    std::uintptr_t               address = 0;
+    std::vector<cyanide::byte_t> previous;
+    std::vector<cyanide::byte_t> current;
+};
+
+/*
+ * Pages written since the previous call (or since allocation), the result can
+ * be passed to memory_snapshot::update to skip the clean pages.
+ *
+ * Only works for memory allocated with MEM_WRITE_WATCH.
+ *
+ * @param region Write-watched region.
+ * @param reset Reset the write tracking state of the region.
+ *
+ * @throw std::runtime_error If GetWriteWatch fails, e.g. the region is not
+ * write-watched.
+ */
+std::vector<std::uintptr_t>
+written_pages(const cyanide::memory_region &region, bool reset = true);
+
+/*
+ * Copy of the memory regions that reports which bytes changed since the
+ * previous update:
+ *
+ *     cyanide::memory_snapshot snapshot{process, regions};
+ *     // ...
+ *     for (const auto &diff : snapshot.update())
+ *         cyanide::patch<> revert{
+ *             reinterpret_cast<void *>(diff.address),
+ *             diff.previous};
+ *
+ * Every page is checksummed with CRC32C, so an update reads each page once and
+ * compares byte by byte only the pages whose checksum changed. A checksum
+ * collision makes the change go unnoticed until the next one on that page.
+ */
+template <typename Accessor = cyanide::local_process>
+class memory_snapshot {
+public:
+    static constexpr std::size_t page_size = 0x1000;
+
+    // Snapshot of all the readable memory
+    explicit memory_snapshot(const Accessor &accessor)
+        : memory_snapshot{accessor, accessor.readable_regions()}
+    {}
+
+    /*
+     * @param accessor Memory accessor, must outlive the snapshot.
+     * @param regions Regions to track, the unreadable parts are considered
+     * unchanged.
+     */
+    memory_snapshot(
+        const Accessor                          &accessor,
+        std::span<const cyanide::memory_region> regions)
+        : accessor_{&accessor},
+          scratch_(page_size)
+    {
+        for (const auto &region : regions)
+        {
+            std::uintptr_t       address = region.base;
+            const std::uintptr_t end     = region.base + region.size;
+
+            while (address < end)
+            {
+                const std::uintptr_t next =
+                    std::min(end, (address | (page_size - 1)) + 1);
+
+                pages_.push_back(
+                    {address,
+                     static_cast<std::size_t>(next - address),
+                     0,
+                     data_.size()});
+
+                data_.resize(data_.size() + pages_.back().size);
+
+                address = next;
+            }
+        }
+
+        std::sort(
+            pages_.begin(),
+            pages_.end(),
+            [](const page &lhs, const page &rhs) {
+                return lhs.address < rhs.address;
+            });
+
+        for (auto &current : pages_)
+        {
+            const std::span<cyanide::byte_t> stored{
+                data_.data() + current.offset,
+                current.size};
+
+            accessor_->read(current.address, stored);
+            current.hash = cyanide::detail::crc32c(stored);
+        }
+    }
+
+    /*
+     * Re-read every page and bring the snapshot up to date
+     *
+     * @return Changed ranges, ascending, adjacent ones merged.
+     */
+    std::vector<cyanide::memory_diff> update()
+    {
+        std::vector<cyanide::memory_diff> diffs;
+        changed_pages_ = 0;
+
+        for (auto &current : pages_)
+            update_page(current, diffs);
+
+        return diffs;
+    }
+
+    /*
+     * Same as update(), but re-reads only the specified pages
+     *
+     * @param dirty_pages Any addresses within the pages that may have been
+     * written, e.g. the result of written_pages(). Addresses outside of the
+     * snapshot are ignored.
+     */
+    std::vector<cyanide::memory_diff>
+    update(std::span<const std::uintptr_t> dirty_pages)
+    {
+        std::vector<std::size_t> indices;
+        indices.reserve(dirty_pages.size());
+
+        for (const std::uintptr_t address : dirty_pages)
+        {
+            const auto it = std::upper_bound(
+                pages_.begin(),
+                pages_.end(),
+                address,
+                [](std::uintptr_t value, const page &current) {
+                    return value < current.address;
+                });
+
+            if (it == pages_.begin())
+                continue;
+
+            const page &found = *std::prev(it);
+
+            if (address - found.address < found.size)
+            {
+                indices.push_back(
+                    static_cast<std::size_t>(&found - pages_.data()));
+            }
+        }
+
+        std::sort(indices.begin(), indices.end());
+        indices.erase(
+            std::unique(indices.begin(), indices.end()),
+            indices.end());
+
+        std::vector<cyanide::memory_diff> diffs;
+        changed_pages_ = 0;
+
+        for (const std::size_t index : indices)
+            update_page(pages_[index], diffs);
+
+        return diffs;
+    }
+
+    [[nodiscard]] std::size_t page_count() const noexcept
+    {
+        return pages_.size();
+    }
+
+    // Number of the pages compared byte by byte during the last update
+    [[nodiscard]] std::size_t changed_page_count() const noexcept
+    {
+        return changed_pages_;
+    }
+
+    [[nodiscard]] std::size_t memory_usage() const noexcept
+    {
+        return data_.size() + pages_.size() * sizeof(page);
+    }
+
+protected:
+    struct page {
+        std::uintptr_t address = 0;
+        std::size_t    size    = 0;
+        std::uint32_t  hash    = 0;
+        std::size_t    offset  = 0; // Offset of the stored bytes in data_
+    };
+
+    const Accessor              *accessor_ = nullptr;
+    std::vector<page>            pages_;
+    std::vector<cyanide::byte_t> data_;
+    std::vector<cyanide::byte_t> scratch_;
+    std::size_t                  changed_pages_ = 0;
+
+    void update_page(page &current, std::vector<cyanide::memory_diff> &diffs)
+    {
+        cyanide::byte_t *stored = data_.data() + current.offset;
+
+        const std::size_t bytes_read = accessor_->read(
+            current.address,
+            std::span{scratch_.data(), current.size});
+
+        // Unreadable tail is considered unchanged
+        std::copy_n(
+            stored + bytes_read,
+            current.size - bytes_read,
+            scratch_.data() + bytes_read);
+
+        const std::uint32_t hash =
+            cyanide::detail::crc32c(std::span{scratch_.data(), current.size});
+
+        if (hash == current.hash)
+            return;
+
+        ++changed_pages_;
+
+        collect_diffs(
+            current.address,
+            stored,
+            scratch_.data(),
+            current.size,
+            diffs);
+
+        std::copy_n(scratch_.data(), current.size, stored);
+        current.hash = hash;
+    }
+
+    static void collect_diffs(
+        std::uintptr_t                     address,
+        const cyanide::byte_t             *previous,
+        const cyanide::byte_t             *current,
+        std::size_t                        size,
+        std::vector<cyanide::memory_diff> &diffs)
+    {
+        std::size_t offset = 0;
+
+        while (offset < size)
+        {
+            // Skip the equal words quickly, then find the exact boundaries
+            while (offset + 8 <= size
+                   && cyanide::safe_pun<std::uint64_t>(previous + offset)
+                          == cyanide::safe_pun<std::uint64_t>(current + offset))
+            {
+                offset += 8;
+            }
+
+            while (offset < size && previous[offset] == current[offset])
+                ++offset;
+
+            if (offset == size)
+                break;
+
+            const std::size_t first = offset;
+
+            while (offset < size && previous[offset] != current[offset])
+                ++offset;
+
+            // Ranges crossing the page boundary come out as a single one
+            if (diffs.empty()
+                || diffs.back().address + diffs.back().current.size()
+                       != address + first)
+            {
+                diffs.push_back({address + first, {}, {}});
+            }
+
+            auto &diff = diffs.back();
+
+            diff.previous.insert(
+                diff.previous.end(),
+                previous + first,
+                previous + offset);
+            diff.current.insert(
+                diff.current.end(),
+                current + first,
+                current + offset);
+        }
+    }
+};
+
+} // namespace cyanide
+
+#endif // !CYANIDE_MEMORY_SNAPSHOT_HPP_
@@ -0,0 +1,63 @@
+#ifndef CYANIDE_OFFSET_TABLE_HPP_
+#define CYANIDE_OFFSET_TABLE_HPP_
+
+#include <cyanide/image_file.hpp>
+#include <cyanide/signature.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <functional> // std::less
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace cyanide {
+
+/*
+ * Named RVAs precomputed offline (see cyanide::image_file), so that the
+ * production process can skip scanning entirely and just add the module base.
+ *
+ * On disk it's a text file with a "<name> <hex rva>" pair per line, the name
+ * ends at the last space of the line.
+ */
+class offset_table {
+public:
+    /*
+     * @throw std::invalid_argument If the name contains a newline.
+     */
+    void set(std::string name, std::uint64_t rva);
+
+    [[nodiscard]] std::optional<std::uint64_t>
+    find(std::string_view name) const;
+
+    /*
+     * Resolve the signature against the image and store the RVA of the first
+     * match under the given name
+     *
+     * @return false if the signature has not been found.
+     *
+     * @throw std::invalid_argument If the name contains a newline.
+     */
+    bool resolve(
+        const cyanide::image_file &image,
+        std::string                name,
+        const cyanide::signature  &sig);
+
+    [[nodiscard]] const std::map<std::string, std::uint64_t, std::less<>> &
+    entries() const noexcept
+    {
+        return offsets_;
+    }
+
+    void save(const std::filesystem::path &path) const;
+
+    [[nodiscard]] static offset_table load(const std::filesystem::path &path);
+
+protected:
+    std::map<std::string, std::uint64_t, std::less<>> offsets_;
+};
+
+} // namespace cyanide
+
+#endif // !CYANIDE_OFFSET_TABLE_HPP_
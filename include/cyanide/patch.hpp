@@ -61,6 +61,16 @@ public:
      */
     friend void swap<>(patch<Storage> &lhs, patch<Storage> &rhs);
 
+    [[nodiscard]] void *address() const noexcept
+    {
+        return address_;
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return patch_size_;
+    }
+
 protected:
     void       *address_    = nullptr;
     std::size_t patch_size_ = 0;
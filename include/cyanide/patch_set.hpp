@@ -0,0 +1,178 @@
+#ifndef CYANIDE_PATCH_SET_HPP_
+#define CYANIDE_PATCH_SET_HPP_
+
+#include <cyanide/defs.hpp>
+#include <cyanide/patch.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cyanide {
+
+// Single patch of the set, the spans point into the file contents
+struct patch_set_entry {
+    std::uint32_t                    module = 0;
+    std::uint64_t                    offset = 0; // From the module base
+    std::span<const cyanide::byte_t> expected;
+    std::span<const cyanide::byte_t> replacement;
+};
+
+/*
+ * Binary patch set, parsed in place:
+ *
+ *     const cyanide::mapped_file file{"fixes.cyps"};
+ *     const cyanide::patch_set   set{file.data()};
+ *
+ *     cyanide::applied_patch_set applied{set, module_bases};
+ *
+ * The format, all the integers are little-endian:
+ *
+ *     header   "CYPS" magic, version, module count, entry count, data size
+ *              and CRC32C of everything after the header, 4 bytes each
+ *     modules  name offset and name size in the data, 4 bytes each
+ *     entries  module-relative offset (8 bytes), module index, patch size,
+ *              data offset and a reserved field (4 bytes each)
+ *     data     module names, the expected bytes of each entry immediately
+ *              followed by its replacement bytes
+ *
+ * The entries are sorted by the module and the offset and don't overlap.
+ * The set doesn't own the data, it must outlive the set.
+ */
+class patch_set {
+public:
+    static constexpr std::uint32_t magic   = 0x53505943; // "CYPS"
+    static constexpr std::uint32_t version = 1;
+
+    /*
+     * Validate the whole file, in a single pass
+     *
+     * @throw std::runtime_error If the data is not a patch set, it's
+     * malformed or the checksum doesn't match.
+     */
+    explicit patch_set(std::span<const cyanide::byte_t> data);
+
+    [[nodiscard]] std::size_t module_count() const noexcept
+    {
+        return module_count_;
+    }
+
+    [[nodiscard]] std::string_view module_name(std::size_t index) const;
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return entry_count_;
+    }
+
+    [[nodiscard]] cyanide::patch_set_entry operator[](std::size_t index) const;
+
+protected:
+    std::span<const cyanide::byte_t> modules_;
+    std::span<const cyanide::byte_t> entries_;
+    std::span<const cyanide::byte_t> data_;
+    std::size_t                      module_count_ = 0;
+    std::size_t                      entry_count_  = 0;
+};
+
+// Producer of the patch set files, e.g. in a build pipeline
+class patch_set_builder {
+public:
+    /*
+     * @param module Module name, as the applying side resolves it.
+     * @param offset Offset of the patch from the module base.
+     * @param expected Bytes to be replaced, checked before applying.
+     * @param replacement Contents of the patch.
+     *
+     * @throw std::invalid_argument If the sizes differ or are zero.
+     */
+    void add(
+        std::string_view                 module,
+        std::uint64_t                    offset,
+        std::span<const cyanide::byte_t> expected,
+        std::span<const cyanide::byte_t> replacement);
+
+    /*
+     * @throw std::invalid_argument If two patches overlap.
+     */
+    [[nodiscard]] std::vector<cyanide::byte_t> build() const;
+
+    void save(const std::filesystem::path &path) const;
+
+protected:
+    struct pending_entry {
+        std::uint32_t                module = 0;
+        std::uint64_t                offset = 0;
+        std::vector<cyanide::byte_t> expected;
+        std::vector<cyanide::byte_t> replacement;
+    };
+
+    std::vector<std::string>   modules_;
+    std::vector<pending_entry> entries_;
+};
+
+/*
+ * Patch set applied to the memory, reverted on destruction.
+ *
+ * All the entries are checked against their expected bytes before anything is
+ * written, so the set is applied either entirely or not at all. The memory
+ * protection is changed once per page, not once per patch.
+ */
+class applied_patch_set {
+public:
+    applied_patch_set() = default;
+
+    /*
+     * @param module_bases Base addresses of the modules, by the module index
+     * of the set.
+     * @param unprotect Make the pages writable while patching.
+     *
+     * @throw std::invalid_argument If the base of a module is missing.
+     * @throw std::runtime_error If the memory doesn't match the expected bytes,
+     * nothing is written then.
+     */
+    applied_patch_set(
+        const cyanide::patch_set        &set,
+        std::span<const std::uintptr_t> module_bases,
+        bool                             unprotect = true);
+
+    ~applied_patch_set();
+
+    applied_patch_set(const applied_patch_set &)            = delete;
+    applied_patch_set &operator=(const applied_patch_set &) = delete;
+
+    applied_patch_set(applied_patch_set &&other) noexcept;
+    applied_patch_set &operator=(applied_patch_set &&other) noexcept;
+
+    friend void swap(applied_patch_set &lhs, applied_patch_set &rhs) noexcept;
+
+    /*
+     * Hot-swap: revert the current patches and apply the other set. The
+     * expected bytes of the new set are checked against the original memory.
+     *
+     * @throw std::runtime_error If the new set doesn't match, the current
+     * patches are put back then.
+     */
+    void replace(
+        const cyanide::patch_set        &set,
+        std::span<const std::uintptr_t> module_bases);
+
+    void revert();
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return patches_.size();
+    }
+
+protected:
+    // Applied without unprotecting, the pages are unprotected in bulk
+    std::vector<cyanide::patch<>> patches_;
+    bool                          unprotect_ = true;
+};
+
+} // namespace cyanide
+
+#endif // !CYANIDE_PATCH_SET_HPP_
@@ -0,0 +1,293 @@
+#ifndef CYANIDE_POINTER_CHAIN_HPP_
+#define CYANIDE_POINTER_CHAIN_HPP_
+
+#include <cyanide/defs.hpp>
+#include <cyanide/detail/prefetch.hpp>
+#include <cyanide/safe_pun.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <utility> // std::forward
+
+namespace cyanide {
+
+/*
+ * Invalidation policies of the pointer chain cache. Each policy must have the
+ * following traits:
+ *
+ * bool is_valid() const;
+ * void before_resolve();
+ * void on_resolved();
+ *
+ * The first one is checked on every access to the cached pointers, the other
+ * two are called around the actual resolution.
+ */
+
+// Cached pointers stay valid until invalidate() is called
+class manual_invalidation {
+protected:
+    bool is_valid() const noexcept
+    {
+        return true;
+    }
+
+    void before_resolve() noexcept {}
+    void on_resolved() noexcept {}
+};
+
+/*
+ * Cached pointers stay valid as long as the generation counter doesn't change,
+ * e.g. increment it on level load to invalidate all the chains at once.
+ */
+class generation_invalidation {
+public:
+    explicit generation_invalidation(
+        const std::atomic<std::uint64_t> &generation) noexcept
+        : generation_{&generation}
+    {}
+
+protected:
+    bool is_valid() const noexcept
+    {
+        return resolved_generation_
+            == generation_->load(std::memory_order_acquire);
+    }
+
+    void before_resolve() noexcept
+    {
+        // The counter is read before the resolution, so that the change made
+        // in the middle of it invalidates the result
+        pending_generation_ = generation_->load(std::memory_order_acquire);
+    }
+
+    void on_resolved() noexcept
+    {
+        resolved_generation_ = pending_generation_;
+    }
+
+private:
+    const std::atomic<std::uint64_t> *generation_          = nullptr;
+    std::uint64_t                     pending_generation_  = 0;
+    std::uint64_t                     resolved_generation_ = 0;
+};
+
+// Cached pointers are re-resolved once they get older than the time-to-live
+class ttl_invalidation {
+public:
+    explicit ttl_invalidation(std::chrono::steady_clock::duration ttl) noexcept
+        : ttl_{ttl}
+    {}
+
+protected:
+    bool is_valid() const noexcept
+    {
+        return std::chrono::steady_clock::now() < expires_at_;
+    }
+
+    void before_resolve() noexcept
+    {
+        pending_expires_at_ = std::chrono::steady_clock::now() + ttl_;
+    }
+
+    void on_resolved() noexcept
+    {
+        expires_at_ = pending_expires_at_;
+    }
+
+private:
+    std::chrono::steady_clock::duration   ttl_{};
+    std::chrono::steady_clock::time_point pending_expires_at_{};
+    std::chrono::steady_clock::time_point expires_at_{};
+};
+
+/*
+ * Multi-level pointer with offsets known at compile time. Each offset but the
+ * last one is followed by a dereference, i.e. [[[base+0x10]+0x48]+0x8] is
+ *
+ *     cyanide::pointer_chain<0x10, 0x48, 0x8> chain{base};
+ *     auto value = chain.read<int>();
+ *
+ * Intermediate pointers are cached, so the dependent loads happen only when
+ * the Invalidation policy says the cache is stale.
+ */
+template <typename Invalidation, std::ptrdiff_t... Offsets>
+class basic_pointer_chain : protected Invalidation {
+public:
+    static constexpr std::size_t levels = sizeof...(Offsets);
+
+    static_assert(levels > 0, "Offsets have not been specified");
+
+    static constexpr std::array<std::ptrdiff_t, levels> offsets{Offsets...};
+
+    /*
+     * @param base Address the first offset is applied to.
+     * @param policy_args Arguments of the Invalidation policy constructor.
+     */
+    template <typename... PolicyArgs>
+    explicit basic_pointer_chain(std::uintptr_t base, PolicyArgs &&...policy_args)
+        : Invalidation{std::forward<PolicyArgs>(policy_args)...},
+          base_{base}
+    {}
+
+    /*
+     * Get the final address, resolving the chain if the cache is stale
+     *
+     * @return 0 if one of the intermediate pointers is null.
+     */
+    std::uintptr_t resolve()
+    {
+        if (is_cached())
+            return resolved_;
+
+        Invalidation::before_resolve();
+
+        std::uintptr_t address = base_;
+
+        for (std::size_t level = 0; level < levels - 1; ++level)
+        {
+            address = load(address + offsets[level]);
+
+            if (address == 0)
+                return resolved_ = 0;
+
+            pointers_[level] = address;
+        }
+
+        resolved_ = address + offsets[levels - 1];
+        Invalidation::on_resolved();
+
+        return resolved_;
+    }
+
+    // Read the value at the final address, std::nullopt if the chain is broken
+    template <typename T>
+    std::optional<T> read()
+    {
+        const std::uintptr_t address = resolve();
+
+        if (address == 0)
+            return std::nullopt;
+
+        return cyanide::safe_pun<T>(
+            reinterpret_cast<const cyanide::byte_t *>(address));
+    }
+
+    /*
+     * Resolve many chains at once. All the chains are advanced by one level
+     * before moving to the next one, and the loads of the next level are
+     * prefetched for all the chains, so the latency of the dependent loads
+     * overlaps across the chains. Chains with valid cache are skipped.
+     */
+    static void resolve_all(std::span<basic_pointer_chain> chains)
+    {
+        for (auto &chain : chains)
+        {
+            chain.pending_ = !chain.is_cached();
+
+            if (chain.pending_)
+            {
+                chain.Invalidation::before_resolve();
+                cyanide::detail::prefetch(
+                    reinterpret_cast<const void *>(chain.base_ + offsets[0]));
+            }
+        }
+
+        for (std::size_t level = 0; level < levels - 1; ++level)
+        {
+            for (auto &chain : chains)
+            {
+                if (!chain.pending_)
+                    continue;
+
+                const std::uintptr_t address =
+                    level == 0 ? chain.base_ : chain.pointers_[level - 1];
+
+                chain.pointers_[level] = load(address + offsets[level]);
+
+                // Broken chain, nothing to resolve further
+                if (chain.pointers_[level] == 0)
+                {
+                    chain.pending_  = false;
+                    chain.resolved_ = 0;
+                }
+            }
+
+            for (const auto &chain : chains)
+            {
+                if (chain.pending_)
+                {
+                    cyanide::detail::prefetch(reinterpret_cast<const void *>(
+                        chain.pointers_[level] + offsets[level + 1]));
+                }
+            }
+        }
+
+        for (auto &chain : chains)
+        {
+            if (!chain.pending_)
+                continue;
+
+            if constexpr (levels == 1)
+                chain.resolved_ = chain.base_ + offsets[0];
+            else
+                chain.resolved_ = chain.pointers_[levels - 2] + offsets[levels - 1];
+
+            chain.pending_  = false;
+            chain.Invalidation::on_resolved();
+        }
+    }
+
+    void invalidate() noexcept
+    {
+        resolved_ = 0;
+    }
+
+    void set_base(std::uintptr_t base) noexcept
+    {
+        base_ = base;
+        invalidate();
+    }
+
+    [[nodiscard]] std::uintptr_t base() const noexcept
+    {
+        return base_;
+    }
+
+    // Cached pointer obtained at the specified level, valid after resolve()
+    [[nodiscard]] std::uintptr_t pointer(std::size_t level) const noexcept
+    {
+        return pointers_[level];
+    }
+
+    [[nodiscard]] bool is_cached() const noexcept
+    {
+        return resolved_ != 0 && Invalidation::is_valid();
+    }
+
+protected:
+    std::uintptr_t base_     = 0;
+    std::uintptr_t resolved_ = 0;
+    bool           pending_  = false;
+
+    // One pointer per dereference, the array is never empty to keep it simple
+    std::array<std::uintptr_t, levels == 1 ? 1 : levels - 1> pointers_{};
+
+    static std::uintptr_t load(std::uintptr_t address) noexcept
+    {
+        return cyanide::safe_pun<std::uintptr_t>(
+            reinterpret_cast<const cyanide::byte_t *>(address));
+    }
+};
+
+template <std::ptrdiff_t... Offsets>
+using pointer_chain =
+    cyanide::basic_pointer_chain<cyanide::manual_invalidation, Offsets...>;
+
+} // namespace cyanide
+
+#endif // !CYANIDE_POINTER_CHAIN_HPP_
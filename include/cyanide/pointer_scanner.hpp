@@ -0,0 +1,184 @@
+#ifndef CYANIDE_POINTER_SCANNER_HPP_
+#define CYANIDE_POINTER_SCANNER_HPP_
+
+#include <cyanide/defs.hpp>
+#include <cyanide/process_memory.hpp>
+#include <cyanide/safe_pun.hpp>
+
+#include <algorithm> // std::min
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace cyanide {
+
+/*
+ * Path from a module-relative static address to the target address:
+ *
+ *     address = [module + module_offset]
+ *     address = [address + offsets[i]] for every offset but the last one
+ *     target  = address + offsets.back()
+ *
+ * which is the same layout cyanide::pointer_chain uses with the module base.
+ */
+struct pointer_path {
+    std::size_t                 module        = 0;
+    std::uintptr_t              module_offset = 0;
+    std::vector<std::ptrdiff_t> offsets;
+
+    /*
+     * Follow the path in another process
+     *
+     * @return std::nullopt if some pointer on the way can't be read.
+     */
+    template <typename Accessor>
+    [[nodiscard]] std::optional<std::uintptr_t>
+    resolve(std::uintptr_t module_base, const Accessor &accessor) const
+    {
+        std::uintptr_t address = module_base + module_offset;
+
+        const auto load = [&accessor](std::uintptr_t from) {
+            cyanide::byte_t bytes[sizeof(std::uintptr_t)]{};
+
+            const bool ok = accessor.read(from, bytes) == sizeof(bytes);
+
+            return ok ? std::optional{cyanide::safe_pun<std::uintptr_t>(bytes)}
+                      : std::nullopt;
+        };
+
+        for (std::size_t i = 0; i < offsets.size(); ++i)
+        {
+            const std::optional<std::uintptr_t> pointer = load(address);
+
+            if (!pointer)
+                return std::nullopt;
+
+            address = *pointer + offsets[i];
+        }
+
+        return address;
+    }
+};
+
+struct pointer_scan_result {
+    // Paths refer to the modules by index, so that the result stays valid
+    // after the modules are relocated
+    std::vector<std::string>          modules;
+    std::vector<cyanide::pointer_path> paths;
+
+    /*
+     * Compact binary format: header, module names, then the paths with
+     * 32-bit offsets.
+     */
+    void save(const std::filesystem::path &path) const;
+
+    [[nodiscard]] static pointer_scan_result
+    load(const std::filesystem::path &path);
+};
+
+/*
+ * Finder of the stable pointer paths to the dynamic address.
+ *
+ * On construction the readable memory is snapshotted into a reverse index,
+ * which maps each pointer value to the addresses holding it. The search then
+ * walks from the target backwards - to all the holders of the values within
+ * max_offset below the target, then to the holders of those, etc. - breadth
+ * first and level by level, splitting each level across the worker threads,
+ * until it reaches the holders located inside the modules.
+ */
+class pointer_scanner {
+public:
+    struct options {
+        // Maximum number of dereferences in the path
+        std::size_t max_depth = 4;
+
+        // Maximum offset applied to the pointer at each level
+        std::uintptr_t max_offset = 0x800;
+
+        std::size_t max_results = 100'000;
+
+        // 0 means std::thread::hardware_concurrency()
+        unsigned int threads = 0;
+    };
+
+    /*
+     * Snapshot the memory
+     *
+     * @param accessor Memory accessor, e.g. cyanide::remote_process.
+     */
+    template <typename Accessor>
+    explicit pointer_scanner(const Accessor &accessor)
+        : regions_{accessor.readable_regions()},
+          modules_{accessor.modules()}
+    {
+        constexpr std::size_t chunk_size = 1024 * 1024;
+
+        std::vector<cyanide::byte_t> chunk(chunk_size);
+
+        for (const auto &region : regions_)
+        {
+            for (std::size_t offset = 0; offset < region.size;
+                 offset += chunk_size)
+            {
+                const std::size_t size =
+                    std::min(chunk_size, region.size - offset);
+
+                const std::size_t bytes_read = accessor.read(
+                    region.base + offset,
+                    std::span{chunk.data(), size});
+
+                index_chunk(
+                    region.base + offset,
+                    std::span{chunk.data(), bytes_read});
+            }
+        }
+
+        finalize_index();
+    }
+
+    [[nodiscard]] cyanide::pointer_scan_result
+    find_paths(std::uintptr_t target, const options &opts) const;
+
+    [[nodiscard]] cyanide::pointer_scan_result
+    find_paths(std::uintptr_t target) const
+    {
+        return find_paths(target, options{});
+    }
+
+    [[nodiscard]] const std::vector<cyanide::module_info> &
+    modules() const noexcept
+    {
+        return modules_;
+    }
+
+    // Number of the pointers in the reverse index
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return index_.size();
+    }
+
+protected:
+    struct index_entry {
+        std::uintptr_t value  = 0;
+        std::uintptr_t holder = 0;
+    };
+
+    std::vector<cyanide::memory_region> regions_;
+    std::vector<cyanide::module_info>   modules_;
+    std::vector<index_entry>            index_;
+
+    void index_chunk(std::uintptr_t base, std::span<const cyanide::byte_t> data);
+    void finalize_index();
+
+    [[nodiscard]] bool is_readable(std::uintptr_t address) const noexcept;
+    [[nodiscard]] std::optional<std::size_t>
+    find_module(std::uintptr_t address) const noexcept;
+};
+
+} // namespace cyanide
+
+#endif // !CYANIDE_POINTER_SCANNER_HPP_
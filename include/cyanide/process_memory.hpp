@@ -0,0 +1,84 @@
+#ifndef CYANIDE_PROCESS_MEMORY_HPP_
+#define CYANIDE_PROCESS_MEMORY_HPP_
+
+#include <cyanide/defs.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace cyanide {
+
+struct memory_region {
+    std::uintptr_t base = 0;
+    std::size_t    size = 0;
+};
+
+struct module_info {
+    std::string    name;
+    std::uintptr_t base = 0;
+    std::size_t    size = 0;
+};
+
+/*
+ * Accessor to the memory of another process.
+ *
+ * The handle is opened with PROCESS_VM_READ and PROCESS_QUERY_INFORMATION
+ * rights, which is enough for scanning.
+ */
+class remote_process {
+public:
+    explicit remote_process(unsigned long process_id);
+    ~remote_process();
+
+    remote_process(const remote_process &)            = delete;
+    remote_process &operator=(const remote_process &) = delete;
+
+    remote_process(remote_process &&other) noexcept;
+    remote_process &operator=(remote_process &&other) noexcept;
+
+    friend void swap(remote_process &lhs, remote_process &rhs) noexcept;
+
+    /*
+     * Read the memory of the process
+     *
+     * @param address Address in the target process.
+     * @param buffer Destination buffer.
+     *
+     * @return Number of bytes actually read, may be less than the buffer size
+     * if the range crosses an inaccessible page.
+     */
+    std::size_t
+    read(std::uintptr_t address, std::span<cyanide::byte_t> buffer) const;
+
+    // Committed regions that can be read without faulting, ascending
+    [[nodiscard]] std::vector<cyanide::memory_region> readable_regions() const;
+
+    // Loaded modules, ascending by base address
+    [[nodiscard]] std::vector<cyanide::module_info> modules() const;
+
+protected:
+    void         *handle_     = nullptr;
+    unsigned long process_id_ = 0;
+};
+
+/*
+ * Accessor to the memory of the current process, has the same interface as
+ * remote_process so that both can be used interchangeably in templates. The
+ * reads stop at an inaccessible page instead of faulting, same as there.
+ */
+class local_process {
+public:
+    std::size_t
+    read(std::uintptr_t address, std::span<cyanide::byte_t> buffer) const;
+
+    [[nodiscard]] std::vector<cyanide::memory_region> readable_regions() const;
+
+    [[nodiscard]] std::vector<cyanide::module_info> modules() const;
+};
+
+} // namespace cyanide
+
+#endif // !CYANIDE_PROCESS_MEMORY_HPP_
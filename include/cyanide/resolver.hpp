@@ -0,0 +1,223 @@
+#ifndef CYANIDE_RESOLVER_HPP_
+#define CYANIDE_RESOLVER_HPP_
+
+#include <cyanide/defs.hpp>
+#include <cyanide/safe_pun.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace cyanide {
+
+/*
+ * Sequence of steps which turns the address of a signature match into the
+ * address the matched instruction refers to.
+ *
+ * For example, the call target of "E8 ?? ?? ?? ??" is
+ *
+ *     cyanide::resolver{}.rel32(1)
+ *
+ * and the value of the global read by "A1 ?? ?? ?? ??" (mov eax, [abs32]) is
+ *
+ *     cyanide::resolver{}.add(1).deref().deref()
+ *
+ * All the reads are done through cyanide::safe_pun, so operands don't have to
+ * be aligned.
+ */
+class resolver {
+public:
+    /*
+     * Follow the relative operand (call/jmp rel32, RIP-relative addressing)
+     *
+     * @param operand_offset Offset of the 4-byte displacement from the current
+     * address.
+     * @param instruction_size Size of the whole instruction, the displacement
+     * is relative to its end. Defaults to the displacement being the last
+     * operand of the instruction.
+     */
+    resolver &rel32(
+        std::ptrdiff_t operand_offset,
+        std::ptrdiff_t instruction_size = -1)
+    {
+        steps_.push_back(
+            {step_kind::rel32,
+             operand_offset,
+             instruction_size < 0 ? operand_offset + 4 : instruction_size});
+
+        return *this;
+    }
+
+    // Replace the current address with the pointer stored at it
+    resolver &deref()
+    {
+        steps_.push_back({step_kind::deref, 0, 0});
+
+        return *this;
+    }
+
+    resolver &add(std::ptrdiff_t offset)
+    {
+        steps_.push_back({step_kind::add, offset, 0});
+
+        return *this;
+    }
+
+    /*
+     * Resolve the match in the current process
+     *
+     * @param match Address of the signature match.
+     */
+    [[nodiscard]] std::uintptr_t resolve(std::uintptr_t match) const
+    {
+        for (const auto &step : steps_)
+            match = apply(step, match, local_reader{});
+
+        return match;
+    }
+
+    [[nodiscard]] std::uintptr_t resolve(const cyanide::byte_t *match) const
+    {
+        return resolve(reinterpret_cast<std::uintptr_t>(match));
+    }
+
+    /*
+     * Resolve the match in another process
+     *
+     * @param match Address of the signature match in the target process.
+     * @param accessor Memory accessor, e.g. cyanide::remote_process.
+     *
+     * @throw std::runtime_error If the target memory can't be read.
+     */
+    template <typename Accessor>
+    [[nodiscard]] std::uintptr_t
+    resolve(std::uintptr_t match, const Accessor &accessor) const
+    {
+        const remote_reader<Accessor> reader{accessor};
+
+        for (const auto &step : steps_)
+            match = apply(step, match, reader);
+
+        return match;
+    }
+
+    /*
+     * Resolve many matches at once. The steps are applied to all the matches
+     * before moving to the next step, so the loads of the different matches
+     * don't depend on each other and can be in flight simultaneously.
+     */
+    [[nodiscard]] std::vector<std::uintptr_t>
+    resolve_all(std::span<const std::uintptr_t> matches) const
+    {
+        std::vector<std::uintptr_t> addresses{matches.begin(), matches.end()};
+
+        for (const auto &step : steps_)
+        {
+            for (auto &address : addresses)
+                address = apply(step, address, local_reader{});
+        }
+
+        return addresses;
+    }
+
+    [[nodiscard]] std::vector<std::uintptr_t>
+    resolve_all(std::span<const cyanide::byte_t *const> matches) const
+    {
+        std::vector<std::uintptr_t> addresses;
+        addresses.reserve(matches.size());
+
+        for (const cyanide::byte_t *match : matches)
+            addresses.push_back(reinterpret_cast<std::uintptr_t>(match));
+
+        return resolve_all(addresses);
+    }
+
+    template <typename Accessor>
+    [[nodiscard]] std::vector<std::uintptr_t> resolve_all(
+        std::span<const std::uintptr_t> matches,
+        const Accessor                 &accessor) const
+    {
+        const remote_reader<Accessor> reader{accessor};
+
+        std::vector<std::uintptr_t> addresses{matches.begin(), matches.end()};
+
+        for (const auto &step : steps_)
+        {
+            for (auto &address : addresses)
+                address = apply(step, address, reader);
+        }
+
+        return addresses;
+    }
+
+protected:
+    enum class step_kind { rel32, deref, add };
+
+    struct step {
+        step_kind      kind;
+        std::ptrdiff_t first;
+        std::ptrdiff_t second;
+    };
+
+    std::vector<step> steps_;
+
+    struct local_reader {
+        template <typename T>
+        T read(std::uintptr_t address) const
+        {
+            return cyanide::safe_pun<T>(
+                reinterpret_cast<const cyanide::byte_t *>(address));
+        }
+    };
+
+    template <typename Accessor>
+    struct remote_reader {
+        const Accessor &accessor;
+
+        template <typename T>
+        T read(std::uintptr_t address) const
+        {
+            std::array<cyanide::byte_t, sizeof(T)> bytes{};
+
+            if (accessor.read(address, bytes) != bytes.size())
+            {
+                throw std::runtime_error{
+                    "Failed to resolve the match - target memory is not "
+                    "readable"};
+            }
+
+            return cyanide::safe_pun<T>(bytes.data());
+        }
+    };
+
+    template <typename Reader>
+    static std::uintptr_t
+    apply(const step &current, std::uintptr_t address, const Reader &reader)
+    {
+        switch (current.kind)
+        {
+            case step_kind::rel32:
+            {
+                const auto displacement = reader.template read<std::int32_t>(
+                    address + current.first);
+
+                return address + current.second + displacement;
+            }
+
+            case step_kind::deref:
+                return reader.template read<std::uintptr_t>(address);
+
+            case step_kind::add:
+                return address + current.first;
+        }
+
+        return address;
+    }
+};
+
+} // namespace cyanide
+
+#endif // !CYANIDE_RESOLVER_HPP_
@@ -1,7 +1,7 @@
 #ifndef CYANIDE_SAFE_PUN_HPP_
 #define CYANIDE_SAFE_PUN_HPP_
 
-#include <cyanide/misc/defs.hpp>
+#include <cyanide/defs.hpp>
 
 #include <bit> // std::bit_cast
 #include <cstddef>
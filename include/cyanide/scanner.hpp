@@ -0,0 +1,176 @@
+#ifndef CYANIDE_SCANNER_HPP_
+#define CYANIDE_SCANNER_HPP_
+
+#include <cyanide/defs.hpp>
+#include <cyanide/signature.hpp>
+
+#include <cstddef>
+#include <iterator> // std::default_sentinel_t
+#include <ranges>   // std::ranges::view_interface
+#include <span>
+#include <vector>
+#include <version> // __cpp_lib_generator
+
+#if defined __cpp_lib_generator
+    #include <generator>
+#endif
+
+namespace cyanide {
+
+/*
+ * Find the first occurrence of the signature
+ *
+ * @param data Memory to scan.
+ * @param sig Signature to search for.
+ *
+ * @return Pointer to the beginning of the match or nullptr if there is none.
+ */
+[[nodiscard]] const cyanide::byte_t *find_pattern(
+    std::span<const cyanide::byte_t> data,
+    const cyanide::signature        &sig) noexcept;
+
+/*
+ * Find all the occurrences of the signature (including overlapping ones)
+ *
+ * @param data Memory to scan.
+ * @param sig Signature to search for.
+ *
+ * @return Pointers to the beginning of the matches, in ascending order.
+ */
+[[nodiscard]] std::vector<const cyanide::byte_t *> find_all_patterns(
+    std::span<const cyanide::byte_t> data,
+    const cyanide::signature        &sig);
+
+/*
+ * Lazy range of the matches, each increment resumes the scan right after the
+ * previous match, so nothing is scanned past the last consumed match:
+ *
+ *     auto matches = cyanide::find_patterns(data, sig)
+ *                  | std::views::filter(is_interesting)
+ *                  | std::views::take(1);
+ *
+ * The signature must outlive the range, the matches point into the data.
+ */
+class pattern_view : public std::ranges::view_interface<pattern_view> {
+public:
+    class iterator {
+    public:
+        using value_type      = const cyanide::byte_t *;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+
+        iterator(
+            const cyanide::byte_t    *match,
+            const cyanide::byte_t    *end,
+            const cyanide::signature *sig) noexcept
+            : match_{match},
+              end_{end},
+              sig_{sig}
+        {}
+
+        const cyanide::byte_t *operator*() const noexcept
+        {
+            return match_;
+        }
+
+        iterator &operator++() noexcept
+        {
+            match_ = cyanide::find_pattern(
+                {match_ + 1, static_cast<std::size_t>(end_ - (match_ + 1))},
+                *sig_);
+
+            return *this;
+        }
+
+        iterator operator++(int) noexcept
+        {
+            iterator previous = *this;
+            ++*this;
+
+            return previous;
+        }
+
+        bool operator==(const iterator &other) const noexcept
+        {
+            return match_ == other.match_;
+        }
+
+        bool operator==(std::default_sentinel_t) const noexcept
+        {
+            return match_ == nullptr;
+        }
+
+    protected:
+        const cyanide::byte_t    *match_ = nullptr;
+        const cyanide::byte_t    *end_   = nullptr;
+        const cyanide::signature *sig_   = nullptr;
+    };
+
+    pattern_view() = default;
+
+    pattern_view(
+        std::span<const cyanide::byte_t> data,
+        const cyanide::signature        &sig) noexcept
+        : data_{data},
+          sig_{&sig}
+    {}
+
+    // The scan for the first match happens here
+    [[nodiscard]] iterator begin() const noexcept
+    {
+        if (!sig_)
+            return {};
+
+        return {
+            cyanide::find_pattern(data_, *sig_),
+            data_.data() + data_.size(),
+            sig_};
+    }
+
+    [[nodiscard]] std::default_sentinel_t end() const noexcept
+    {
+        return {};
+    }
+
+protected:
+    std::span<const cyanide::byte_t> data_;
+    const cyanide::signature        *sig_ = nullptr;
+};
+
+/*
+ * Find the occurrences of the signature lazily, see pattern_view
+ *
+ * @param data Memory to scan.
+ * @param sig Signature to search for.
+ */
+[[nodiscard]] inline cyanide::pattern_view find_patterns(
+    std::span<const cyanide::byte_t> data,
+    const cyanide::signature        &sig) noexcept
+{
+    return {data, sig};
+}
+
+// The view would refer to the destroyed signature
+cyanide::pattern_view find_patterns(
+    std::span<const cyanide::byte_t> data,
+    const cyanide::signature       &&sig) = delete;
+
+#if defined __cpp_lib_generator
+/*
+ * Same as find_patterns, but as a coroutine. The signature is copied into the
+ * coroutine frame, so it may be a temporary.
+ */
+[[nodiscard]] std::generator<const cyanide::byte_t *> generate_patterns(
+    std::span<const cyanide::byte_t> data,
+    cyanide::signature               sig);
+#endif
+
+} // namespace cyanide
+
+// The matches point into the scanned data, not into the view
+template <>
+inline constexpr bool
+    std::ranges::enable_borrowed_range<cyanide::pattern_view> = true;
+
+#endif // !CYANIDE_SCANNER_HPP_
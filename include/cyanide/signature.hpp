@@ -0,0 +1,100 @@
+#ifndef CYANIDE_SIGNATURE_HPP_
+#define CYANIDE_SIGNATURE_HPP_
+
+#include <cyanide/defs.hpp>
+
+#include <cstddef>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace cyanide {
+
+/*
+ * Byte pattern with optional wildcards, e.g. "E8 ?? ?? ?? ?? 8B 45 08".
+ *
+ * Scanner doesn't compare the whole pattern at every position. Instead, it
+ * searches for two fixed bytes of the pattern (the anchors) using SIMD and
+ * verifies the rest of the pattern only when both anchors are hit. The anchors
+ * are the rarest bytes of the pattern according to the x86 code statistics,
+ * so common bytes like 00, FF or 8B don't flood the scanner with false hits.
+ */
+class signature {
+public:
+    /*
+     * Parse the IDA-style pattern
+     *
+     * @param pattern Space-separated hex bytes, "?" or "??" for wildcards.
+     */
+    explicit signature(std::string_view pattern);
+
+    /*
+     * Construct the signature from code-style pattern
+     *
+     * @param bytes Pattern bytes.
+     * @param mask String of the same length as @p bytes, where 'x' denotes
+     * fixed byte and '?' denotes wildcard.
+     */
+    signature(std::span<const cyanide::byte_t> bytes, std::string_view mask);
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return bytes_.size();
+    }
+
+    [[nodiscard]] std::span<const cyanide::byte_t> bytes() const noexcept
+    {
+        return bytes_;
+    }
+
+    [[nodiscard]] std::span<const cyanide::byte_t> mask() const noexcept
+    {
+        return mask_;
+    }
+
+    // Offset of the byte the scanner searches for, always a fixed one (unless
+    // the whole pattern consists of wildcards)
+    [[nodiscard]] std::size_t anchor() const noexcept
+    {
+        return anchor_;
+    }
+
+    // Offset of the byte checked together with the anchor, same as the anchor
+    // if there is only one fixed byte
+    [[nodiscard]] std::size_t second_anchor() const noexcept
+    {
+        return second_anchor_;
+    }
+
+    [[nodiscard]] bool has_fixed_bytes() const noexcept
+    {
+        return has_fixed_bytes_;
+    }
+
+    // The caller is responsible for @p data to have at least size() bytes
+    [[nodiscard]] bool matches(const cyanide::byte_t *data) const noexcept
+    {
+        for (std::size_t i = 0; i < bytes_.size(); ++i)
+        {
+            if ((data[i] & mask_[i]) != bytes_[i])
+                return false;
+        }
+
+        return true;
+    }
+
+protected:
+    // Bytes are stored pre-masked (wildcards are zeroed), so that matching is
+    // just (data & mask) == bytes
+    std::vector<cyanide::byte_t> bytes_;
+    std::vector<cyanide::byte_t> mask_;
+    std::size_t                  anchor_          = 0;
+    std::size_t                  second_anchor_   = 0;
+    bool                         has_fixed_bytes_ = false;
+
+    void select_anchor();
+};
+
+} // namespace cyanide
+
+#endif // !CYANIDE_SIGNATURE_HPP_
@@ -0,0 +1,79 @@
+#ifndef CYANIDE_STREAM_SCANNER_HPP_
+#define CYANIDE_STREAM_SCANNER_HPP_
+
+#include <cyanide/defs.hpp>
+#include <cyanide/process_memory.hpp>
+#include <cyanide/signature.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional> // std::function
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace cyanide {
+
+/*
+ * Scanner of another process's memory, which doesn't copy the whole address
+ * space before scanning.
+ *
+ * Readable regions are read in fixed-size windows, each subsequent window
+ * overlapping the previous one by (signature size - 1) bytes, so that the
+ * matches crossing the window boundary are neither lost nor reported twice.
+ * Two window buffers are used: while one of them is being scanned, the next
+ * window is read into the other one by the reader thread. Peak memory usage
+ * is therefore 2 * window_size regardless of the target size.
+ */
+class stream_scanner {
+public:
+    static constexpr std::size_t default_window_size = 1024 * 1024;
+
+    /*
+     * @param process Process to scan, must outlive the scanner.
+     * @param window_size Size of a single read.
+     */
+    explicit stream_scanner(
+        const cyanide::remote_process &process,
+        std::size_t                    window_size = default_window_size);
+
+    /*
+     * Scan all the readable regions of the process
+     *
+     * @param sig Signature to search for, must not be longer than the window.
+     * @param on_match Called with the address of each match in ascending
+     * order. Return false to stop the scan.
+     */
+    void scan(
+        const cyanide::signature                  &sig,
+        const std::function<bool(std::uintptr_t)> &on_match);
+
+    /*
+     * Scan the specified regions only
+     *
+     * @param sig Signature to search for, must not be longer than the window.
+     * @param regions Regions to scan, in ascending order.
+     * @param on_match Called with the address of each match in ascending
+     * order. Return false to stop the scan.
+     */
+    void scan(
+        const cyanide::signature                  &sig,
+        std::span<const cyanide::memory_region>    regions,
+        const std::function<bool(std::uintptr_t)> &on_match);
+
+    [[nodiscard]] std::vector<std::uintptr_t>
+    scan_all(const cyanide::signature &sig);
+
+    [[nodiscard]] std::optional<std::uintptr_t>
+    scan_first(const cyanide::signature &sig);
+
+protected:
+    const cyanide::remote_process                *process_ = nullptr;
+    std::size_t                                   window_size_{};
+    std::array<std::vector<cyanide::byte_t>, 2> buffers_;
+};
+
+} // namespace cyanide
+
+#endif // !CYANIDE_STREAM_SCANNER_HPP_
@@ -0,0 +1,355 @@
+#ifndef CYANIDE_TYPED_VIEW_HPP_
+#define CYANIDE_TYPED_VIEW_HPP_
+
+#include <cyanide/defs.hpp>
+#include <cyanide/detail/gather.hpp>
+#include <cyanide/safe_pun.hpp>
+
+#include <algorithm> // std::min
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <iterator> // std::random_access_iterator_tag
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace cyanide {
+
+/*
+ * Values of the same type lying at the fixed distance from each other in raw
+ * memory, e.g. a field of every element of an array of structs:
+ *
+ *     // health of each entity, 0x240 bytes apart
+ *     const cyanide::strided_view<float> health{entities + 0x1C, count, 0x240};
+ *
+ *     for (const float value : health)
+ *         // ...
+ *
+ *     std::vector<float> copy(health.size());
+ *     health.copy_out(copy);
+ *
+ * The values are read with cyanide::safe_pun semantics, so they don't have to
+ * be aligned and no object has to live there. The iteration reads one value at
+ * a time, copy_out reads in bulk (see cyanide::detail::gather_strided).
+ *
+ * The view only describes the memory, the same view can be read in another
+ * process through an accessor (e.g. cyanide::remote_process).
+ */
+template <typename T>
+class strided_view {
+    static_assert(
+        std::is_trivially_copyable_v<T>,
+        "Values are copied out of the raw memory");
+
+public:
+    class iterator {
+    public:
+        using iterator_concept  = std::random_access_iterator_tag;
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = T;
+        using difference_type   = std::ptrdiff_t;
+
+        iterator() = default;
+
+        iterator(const cyanide::byte_t *current, std::size_t stride) noexcept
+            : current_{current},
+              stride_{stride}
+        {}
+
+        // By value, there is no object to refer to
+        T operator*() const
+        {
+            return cyanide::safe_pun<T>(current_);
+        }
+
+        T operator[](difference_type offset) const
+        {
+            return *(*this + offset);
+        }
+
+        iterator &operator++() noexcept
+        {
+            current_ += stride_;
+            return *this;
+        }
+
+        iterator operator++(int) noexcept
+        {
+            iterator previous = *this;
+            ++*this;
+
+            return previous;
+        }
+
+        iterator &operator--() noexcept
+        {
+            current_ -= stride_;
+            return *this;
+        }
+
+        iterator operator--(int) noexcept
+        {
+            iterator previous = *this;
+            --*this;
+
+            return previous;
+        }
+
+        iterator &operator+=(difference_type offset) noexcept
+        {
+            current_ += offset * static_cast<difference_type>(stride_);
+            return *this;
+        }
+
+        iterator &operator-=(difference_type offset) noexcept
+        {
+            return *this += -offset;
+        }
+
+        friend iterator operator+(iterator it, difference_type offset) noexcept
+        {
+            return it += offset;
+        }
+
+        friend iterator operator+(difference_type offset, iterator it) noexcept
+        {
+            return it += offset;
+        }
+
+        friend iterator operator-(iterator it, difference_type offset) noexcept
+        {
+            return it -= offset;
+        }
+
+        friend difference_type
+        operator-(const iterator &lhs, const iterator &rhs) noexcept
+        {
+            return (lhs.current_ - rhs.current_)
+                 / static_cast<difference_type>(lhs.stride_);
+        }
+
+        friend bool
+        operator==(const iterator &lhs, const iterator &rhs) noexcept
+        {
+            return lhs.current_ == rhs.current_;
+        }
+
+        friend std::strong_ordering
+        operator<=>(const iterator &lhs, const iterator &rhs) noexcept
+        {
+            return lhs.current_ <=> rhs.current_;
+        }
+
+    private:
+        const cyanide::byte_t *current_ = nullptr;
+        std::size_t            stride_  = sizeof(T);
+    };
+
+    strided_view() = default;
+
+    /*
+     * @param data Address of the first value.
+     * @param count Number of the values.
+     * @param stride Distance between the values in bytes.
+     *
+     * @throw std::invalid_argument If the stride is zero.
+     */
+    strided_view(const void *data, std::size_t count, std::size_t stride)
+        : strided_view{reinterpret_cast<std::uintptr_t>(data), count, stride}
+    {}
+
+    // Same as above, the address is in another process
+    strided_view(std::uintptr_t address, std::size_t count, std::size_t stride)
+        : data_{address},
+          count_{count},
+          stride_{stride}
+    {
+        if (stride_ == 0)
+            throw std::invalid_argument{"Stride must be non-zero"};
+    }
+
+    /*
+     * Copy of the view which prefetches the values ahead in copy_out
+     *
+     * @param distance Number of the values ahead, worth it when the stride is
+     * larger than the cache line and the memory is not in the cache yet.
+     */
+    [[nodiscard]] strided_view with_prefetch(std::size_t distance) const
+    {
+        strided_view result = *this;
+        result.prefetch_distance_ = distance;
+
+        return result;
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return count_;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return count_ == 0;
+    }
+
+    [[nodiscard]] std::size_t stride() const noexcept
+    {
+        return stride_;
+    }
+
+    [[nodiscard]] std::uintptr_t address() const noexcept
+    {
+        return data_;
+    }
+
+    [[nodiscard]] T operator[](std::size_t index) const
+    {
+        return cyanide::safe_pun<T>(local_data() + index * stride_);
+    }
+
+    [[nodiscard]] iterator begin() const noexcept
+    {
+        return {local_data(), stride_};
+    }
+
+    [[nodiscard]] iterator end() const noexcept
+    {
+        return begin() + static_cast<std::ptrdiff_t>(count_);
+    }
+
+    // Values from the first one on, as many as fit into the view
+    [[nodiscard]] strided_view subview(std::size_t first) const noexcept
+    {
+        strided_view result = *this;
+
+        first = std::min(first, count_);
+
+        result.data_ += first * stride_;
+        result.count_ -= first;
+
+        return result;
+    }
+
+    /*
+     * Copy the values of the current process into the contiguous buffer
+     *
+     * @return Number of the values copied, the smaller of the view and the
+     * output sizes.
+     */
+    std::size_t copy_out(std::span<T> output) const noexcept
+    {
+        const std::size_t count = std::min(output.size(), count_);
+
+        cyanide::detail::gather_strided(
+            local_data(),
+            stride_,
+            count,
+            output.data(),
+            prefetch_distance_);
+
+        return count;
+    }
+
+    /*
+     * Copy the values through the memory accessor. The memory is read in
+     * chunks spanning as many values as fit into the chunk, the values are
+     * then gathered from the chunk.
+     *
+     * @param accessor Memory accessor, e.g. cyanide::remote_process.
+     *
+     * @return Number of the values copied, less than requested if the memory
+     * becomes unreadable.
+     */
+    template <typename Accessor>
+    std::size_t copy_out(const Accessor &accessor, std::span<T> output) const
+    {
+        constexpr std::size_t chunk_size = 0x10000;
+
+        const std::size_t count = std::min(output.size(), count_);
+
+        // Values per chunk, at least one even if the stride exceeds the chunk
+        const std::size_t per_chunk =
+            stride_ < chunk_size ? (chunk_size - sizeof(T)) / stride_ + 1 : 1;
+
+        std::vector<cyanide::byte_t> chunk;
+
+        for (std::size_t first = 0; first < count; first += per_chunk)
+        {
+            const std::size_t values = std::min(per_chunk, count - first);
+            const std::size_t bytes  = (values - 1) * stride_ + sizeof(T);
+
+            chunk.resize(bytes);
+
+            const std::size_t bytes_read =
+                accessor.read(data_ + first * stride_, chunk);
+
+            if (bytes_read < bytes)
+            {
+                // Whatever values were read completely
+                const std::size_t complete =
+                    bytes_read < sizeof(T)
+                        ? 0
+                        : (bytes_read - sizeof(T)) / stride_ + 1;
+
+                cyanide::detail::gather_strided(
+                    chunk.data(),
+                    stride_,
+                    complete,
+                    output.data() + first);
+
+                return first + complete;
+            }
+
+            cyanide::detail::gather_strided(
+                chunk.data(),
+                stride_,
+                values,
+                output.data() + first);
+        }
+
+        return count;
+    }
+
+protected:
+    std::uintptr_t data_              = 0;
+    std::size_t    count_             = 0;
+    std::size_t    stride_            = sizeof(T);
+    std::size_t    prefetch_distance_ = 0;
+
+    [[nodiscard]] const cyanide::byte_t *local_data() const noexcept
+    {
+        return reinterpret_cast<const cyanide::byte_t *>(data_);
+    }
+};
+
+/*
+ * Array of values in raw memory, packed without gaps:
+ *
+ *     const cyanide::typed_view<std::uint32_t> ids{table, count};
+ *
+ * Same as cyanide::strided_view with the stride of the value size, copy_out
+ * is a single memcpy then.
+ */
+template <typename T>
+class typed_view : public strided_view<T> {
+public:
+    typed_view() = default;
+
+    typed_view(const void *data, std::size_t count)
+        : strided_view<T>{data, count, sizeof(T)}
+    {}
+
+    typed_view(std::uintptr_t address, std::size_t count)
+        : strided_view<T>{address, count, sizeof(T)}
+    {}
+
+    explicit typed_view(std::span<const cyanide::byte_t> bytes)
+        : typed_view{bytes.data(), bytes.size() / sizeof(T)}
+    {}
+};
+
+} // namespace cyanide
+
+#endif // !CYANIDE_TYPED_VIEW_HPP_
@@ -0,0 +1,340 @@
+#ifndef CYANIDE_VALUE_SCANNER_HPP_
+#define CYANIDE_VALUE_SCANNER_HPP_
+
+#include <cyanide/defs.hpp>
+#include <cyanide/detail/candidate_set.hpp>
+#include <cyanide/detail/value_compare.hpp>
+#include <cyanide/process_memory.hpp>
+#include <cyanide/safe_pun.hpp>
+#include <cyanide/scanner.hpp>
+#include <cyanide/signature.hpp>
+
+#include <bit> // std::countr_zero
+#include <cstddef>
+#include <cstdint>
+#include <cstring> // std::memcmp
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace cyanide {
+
+/*
+ * Search for the addresses holding the specified value and narrow them down
+ * by re-scanning:
+ *
+ *     cyanide::value_scanner<int> scanner{process};
+ *
+ *     scanner.first_scan(cyanide::scan_condition::equal, 100);
+ *     // ... the value changes to 90
+ *     scanner.next_scan(cyanide::scan_condition::decreased);
+ *     scanner.next_scan(cyanide::scan_condition::equal, 90);
+ *
+ * 4-byte values (integers and floats) at the default alignment are compared
+ * with SSE2 or AVX2 (if enabled), 64 values per step. See
+ * cyanide::detail::candidate_set for the way the candidates are stored.
+ */
+template <typename T, typename Accessor = cyanide::local_process>
+class value_scanner {
+    static_assert(std::is_arithmetic_v<T>, "Only arithmetic values supported");
+
+public:
+    /*
+     * @param accessor Memory accessor, must outlive the scanner.
+     * @param alignment Alignment of the values to search for.
+     */
+    explicit value_scanner(
+        const Accessor &accessor,
+        std::size_t     alignment = alignof(T))
+        : accessor_{&accessor},
+          candidates_{alignment, sizeof(T)}
+    {}
+
+    /*
+     * Scan all the readable memory
+     *
+     * @throw std::invalid_argument If the condition is relative (there is no
+     * previous scan to compare with).
+     */
+    void first_scan(cyanide::scan_condition condition, T value)
+    {
+        if (cyanide::detail::is_relative(condition))
+        {
+            throw std::invalid_argument{
+                "Relative condition can't be used in the first scan"};
+        }
+
+        const std::size_t stride = candidates_.stride();
+
+        candidates_.first_pass(
+            *accessor_,
+            [&](std::span<const cyanide::byte_t> data,
+                std::size_t                      slots,
+                std::uint64_t                   *bits) {
+                cyanide::detail::compare_values(
+                    data.data(),
+                    stride,
+                    slots,
+                    condition,
+                    value,
+                    bits);
+            });
+    }
+
+    /*
+     * Narrow down the candidates of the previous scan
+     *
+     * @param condition Condition to check.
+     * @param value Value to compare with, ignored for relative conditions.
+     */
+    void next_scan(cyanide::scan_condition condition, T value = T{})
+    {
+        const std::size_t stride = candidates_.stride();
+
+        if (cyanide::detail::is_relative(condition))
+        {
+            candidates_.next_pass(
+                *accessor_,
+                [&](std::span<const cyanide::byte_t> data,
+                    std::size_t                      slots,
+                    std::uint64_t                   *bits,
+                    packed_values                    previous) {
+                    std::size_t index = 0;
+
+                    for (std::size_t word = 0; word < (slots + 63) / 64; ++word)
+                    {
+                        for (std::uint64_t current = bits[word]; current != 0;
+                             current &= current - 1, ++index)
+                        {
+                            const auto bit = std::countr_zero(current);
+                            const std::size_t slot =
+                                word * 64 + static_cast<std::size_t>(bit);
+
+                            if (slot >= slots)
+                                break;
+
+                            const T current_value =
+                                cyanide::safe_pun<T>(data.data() + slot * stride);
+                            const T previous_value =
+                                cyanide::safe_pun<T>(previous[index]);
+
+                            if (!cyanide::detail::holds(
+                                    condition,
+                                    current_value,
+                                    previous_value))
+                            {
+                                bits[word] &= ~(std::uint64_t{1} << bit);
+                            }
+                        }
+                    }
+                });
+        }
+        else
+        {
+            candidates_.next_pass(
+                *accessor_,
+                [&](std::span<const cyanide::byte_t> data,
+                    std::size_t                      slots,
+                    std::uint64_t                   *bits,
+                    packed_values) {
+                    scratch_.resize((slots + 63) / 64);
+
+                    cyanide::detail::compare_values(
+                        data.data(),
+                        stride,
+                        slots,
+                        condition,
+                        value,
+                        scratch_.data());
+
+                    for (std::size_t word = 0; word < scratch_.size(); ++word)
+                        bits[word] &= scratch_[word];
+                });
+        }
+    }
+
+    // Number of the candidates left
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return candidates_.size();
+    }
+
+    [[nodiscard]] std::size_t memory_usage() const noexcept
+    {
+        return candidates_.memory_usage();
+    }
+
+    // Call f(std::uintptr_t address, T value) for every candidate, where
+    // value is the one read during the last scan
+    template <typename F>
+    void for_each(F &&f) const
+    {
+        candidates_.for_each(
+            [&f](std::uintptr_t address, const cyanide::byte_t *value) {
+                f(address, cyanide::safe_pun<T>(value));
+            });
+    }
+
+    [[nodiscard]] std::vector<std::uintptr_t> addresses() const
+    {
+        std::vector<std::uintptr_t> result;
+        result.reserve(size());
+
+        for_each([&result](std::uintptr_t address, T) {
+            result.push_back(address);
+        });
+
+        return result;
+    }
+
+    void reset() noexcept
+    {
+        candidates_.clear();
+    }
+
+protected:
+    using packed_values = cyanide::detail::candidate_set::packed_values;
+
+    const Accessor                *accessor_ = nullptr;
+    cyanide::detail::candidate_set candidates_;
+    std::vector<std::uint64_t>     scratch_;
+};
+
+/*
+ * Same as cyanide::value_scanner, but for the byte strings of the fixed size.
+ * The first scan uses the signature scanner, the next ones support equal (to
+ * the new string), changed and unchanged conditions.
+ */
+template <typename Accessor = cyanide::local_process>
+class byte_string_scanner {
+public:
+    byte_string_scanner(const Accessor &accessor, std::size_t size)
+        : accessor_{&accessor},
+          size_{size},
+          candidates_{1, size}
+    {
+        if (size_ == 0)
+            throw std::invalid_argument{"Byte string must not be empty"};
+    }
+
+    void first_scan(std::span<const cyanide::byte_t> bytes)
+    {
+        check_size(bytes);
+
+        const cyanide::signature sig{bytes, std::string(bytes.size(), 'x')};
+
+        candidates_.first_pass(
+            *accessor_,
+            [&sig](std::span<const cyanide::byte_t> data,
+                   std::size_t                      slots,
+                   std::uint64_t                   *bits) {
+                for (const cyanide::byte_t *match :
+                     cyanide::find_all_patterns(data, sig))
+                {
+                    const auto slot =
+                        static_cast<std::size_t>(match - data.data());
+
+                    if (slot < slots)
+                        bits[slot / 64] |= std::uint64_t{1} << (slot % 64);
+                }
+            });
+    }
+
+    // Keep the candidates which hold the specified string now
+    void next_scan(std::span<const cyanide::byte_t> bytes)
+    {
+        check_size(bytes);
+
+        next_pass([&bytes](const cyanide::byte_t *current, const cyanide::byte_t *) {
+            return std::memcmp(current, bytes.data(), bytes.size()) == 0;
+        });
+    }
+
+    /*
+     * @param condition Either changed or unchanged.
+     */
+    void next_scan(cyanide::scan_condition condition)
+    {
+        if (condition != cyanide::scan_condition::changed
+            && condition != cyanide::scan_condition::unchanged)
+        {
+            throw std::invalid_argument{
+                "Byte strings support only changed and unchanged conditions"};
+        }
+
+        const bool expect_equal = condition == cyanide::scan_condition::unchanged;
+
+        next_pass([this, expect_equal](
+                      const cyanide::byte_t *current,
+                      const cyanide::byte_t *previous) {
+            return (std::memcmp(current, previous, size_) == 0) == expect_equal;
+        });
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return candidates_.size();
+    }
+
+    [[nodiscard]] std::vector<std::uintptr_t> addresses() const
+    {
+        std::vector<std::uintptr_t> result;
+
+        candidates_.for_each([&result](std::uintptr_t address, const auto *) {
+            result.push_back(address);
+        });
+
+        return result;
+    }
+
+protected:
+    using packed_values = cyanide::detail::candidate_set::packed_values;
+
+    const Accessor                *accessor_ = nullptr;
+    std::size_t                    size_     = 0;
+    cyanide::detail::candidate_set candidates_;
+
+    void check_size(std::span<const cyanide::byte_t> bytes) const
+    {
+        if (bytes.size() != size_)
+            throw std::invalid_argument{"Byte string size mismatch"};
+    }
+
+    template <typename Predicate>
+    void next_pass(Predicate predicate)
+    {
+        candidates_.next_pass(
+            *accessor_,
+            [&](std::span<const cyanide::byte_t> data,
+                std::size_t                      slots,
+                std::uint64_t                   *bits,
+                packed_values                    previous) {
+                std::size_t index = 0;
+
+                for (std::size_t word = 0; word < (slots + 63) / 64; ++word)
+                {
+                    for (std::uint64_t current = bits[word]; current != 0;
+                         current &= current - 1, ++index)
+                    {
+                        const auto        bit = std::countr_zero(current);
+                        const std::size_t slot =
+                            word * 64 + static_cast<std::size_t>(bit);
+
+                        if (slot >= slots)
+                            break;
+
+                        if (!predicate(data.data() + slot, previous[index]))
+                        {
+                            bits[word] &= ~(std::uint64_t{1} << bit);
+                        }
+                    }
+                }
+            });
+    }
+};
+
+} // namespace cyanide
+
+#endif // !CYANIDE_VALUE_SCANNER_HPP_
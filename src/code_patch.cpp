@@ -0,0 +1,142 @@
+#include <cyanide/code_patch.hpp>
+#include <cyanide/instruction_length.hpp>
+#include <cyanide/patch.hpp>
+
+#include <algorithm> // std::copy
+#include <cstddef>
+#include <cstdint>
+#include <cstring> // std::memcpy
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace cyanide {
+
+namespace {
+    constexpr cyanide::byte_t jmp_rel8  = 0xEB;
+    constexpr cyanide::byte_t jmp_rel32 = 0xE9;
+
+    constexpr std::size_t max_instruction_length = 15;
+
+    // Lengths of the whole instructions covering at least min_size bytes
+    std::vector<std::size_t>
+    instruction_lengths(const void *address, std::size_t min_size)
+    {
+        const auto *code = static_cast<const cyanide::byte_t *>(address);
+
+        std::vector<std::size_t> lengths;
+        std::size_t              size = 0;
+
+        while (size < min_size)
+        {
+            // The instruction can't be longer, so no more is read
+            const std::size_t length = cyanide::instruction_length(
+                std::span{code + size, max_instruction_length});
+
+            if (length == 0)
+            {
+                throw std::runtime_error{
+                    "Failed to decode the instruction at the offset "
+                    + std::to_string(size)};
+            }
+
+            lengths.push_back(length);
+            size += length;
+        }
+
+        return lengths;
+    }
+} // namespace
+
+std::size_t instruction_boundary(const void *address, std::size_t min_size)
+{
+    std::size_t size = 0;
+
+    for (const std::size_t length : instruction_lengths(address, min_size))
+        size += length;
+
+    return size;
+}
+
+cyanide::patch<>
+make_nop_patch(void *address, std::size_t min_size, bool unprotect)
+{
+    const std::vector<std::size_t> lengths =
+        instruction_lengths(address, min_size);
+
+    std::size_t size = 0;
+
+    for (const std::size_t length : lengths)
+        size += length;
+
+    std::vector<cyanide::byte_t> code(size);
+
+    /*
+     * Each of the original instructions becomes its own NOPs, so the existing
+     * branches into the region land on a NOP and fall through to its end
+     */
+    std::size_t offset = 0;
+
+    for (const std::size_t length : lengths)
+    {
+        cyanide::fill_nops(std::span{code}.subspan(offset, length));
+        offset += length;
+    }
+
+    if (size <= cyanide::nop_jump_threshold)
+        return cyanide::patch<>{address, code, unprotect};
+
+    // The jmp replaces the first instruction long enough to hold it
+    offset = 0;
+
+    for (const std::size_t length : lengths)
+    {
+        const std::size_t rest = size - offset;
+
+        if (rest <= cyanide::nop_jump_threshold)
+            break;
+
+        if (length >= 2 && rest - 2 <= 0x7F)
+        {
+            code[offset]     = jmp_rel8;
+            code[offset + 1] = static_cast<cyanide::byte_t>(rest - 2);
+            cyanide::fill_nops(std::span{code}.subspan(offset + 2, length - 2));
+
+            break;
+        }
+
+        if (length >= 5)
+        {
+            const auto displacement = static_cast<std::int32_t>(rest - 5);
+
+            code[offset] = jmp_rel32;
+            std::memcpy(&code[offset + 1], &displacement, sizeof(displacement));
+            cyanide::fill_nops(std::span{code}.subspan(offset + 5, length - 5));
+
+            break;
+        }
+
+        offset += length;
+    }
+
+    return cyanide::patch<>{address, code, unprotect};
+}
+
+cyanide::patch<> make_code_patch(
+    void                            *address,
+    std::span<const cyanide::byte_t> code,
+    bool                             unprotect)
+{
+    const std::size_t size =
+        cyanide::instruction_boundary(address, code.size());
+
+    std::vector<cyanide::byte_t> padded(size);
+
+    std::copy(code.begin(), code.end(), padded.begin());
+    cyanide::fill_nops(std::span{padded}.subspan(code.size()));
+
+    return cyanide::patch<>{address, padded, unprotect};
+}
+
+} // namespace cyanide
@@ -0,0 +1,340 @@
+#if !defined _WIN32
+    #error "Unsupported platform"
+#endif
+
+#include <cyanide/deferred_hooks.hpp>
+#include <cyanide/scanner.hpp>
+
+#include <Windows.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <exception> // std::exception_ptr, std::current_exception
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility> // std::move
+#include <variant>
+#include <vector>
+
+namespace cyanide {
+
+namespace {
+    // Loader structures, not present in the SDK headers
+    struct unicode_string {
+        USHORT length;
+        USHORT maximum_length;
+        PWSTR  buffer;
+    };
+
+    struct dll_notification_data {
+        ULONG                 flags;
+        const unicode_string *full_dll_name;
+        const unicode_string *base_dll_name;
+        PVOID                 dll_base;
+        ULONG                 size_of_image;
+    };
+
+    constexpr ULONG notification_reason_loaded   = 1;
+    constexpr ULONG notification_reason_unloaded = 2;
+
+    using notification_function_t =
+        VOID(CALLBACK *)(ULONG reason, const void *data, PVOID context);
+
+    using register_notification_t = LONG(NTAPI *)(
+        ULONG                   flags,
+        notification_function_t notification_function,
+        PVOID                   context,
+        PVOID                  *cookie);
+
+    using unregister_notification_t = LONG(NTAPI *)(PVOID cookie);
+
+    template <typename T>
+    T ntdll_function(const char *name)
+    {
+        const HMODULE ntdll = GetModuleHandleW(L"ntdll.dll");
+
+        const auto function =
+            ntdll ? reinterpret_cast<T>(GetProcAddress(ntdll, name)) : nullptr;
+
+        if (!function)
+            throw std::runtime_error{std::string{name} + " is not available"};
+
+        return function;
+    }
+
+    std::wstring to_wide(std::string_view utf8)
+    {
+        if (utf8.empty())
+            return {};
+
+        const int size = MultiByteToWideChar(
+            CP_UTF8,
+            0,
+            utf8.data(),
+            static_cast<int>(utf8.size()),
+            nullptr,
+            0);
+
+        std::wstring result(static_cast<std::size_t>(size), L'\0');
+
+        MultiByteToWideChar(
+            CP_UTF8,
+            0,
+            utf8.data(),
+            static_cast<int>(utf8.size()),
+            result.data(),
+            size);
+
+        return result;
+    }
+
+    bool is_same_module(std::wstring_view lhs, std::wstring_view rhs)
+    {
+        return CompareStringOrdinal(
+                   lhs.data(),
+                   static_cast<int>(lhs.size()),
+                   rhs.data(),
+                   static_cast<int>(rhs.size()),
+                   TRUE)
+            == CSTR_EQUAL;
+    }
+
+    const IMAGE_NT_HEADERS *nt_headers(std::uintptr_t base)
+    {
+        const auto *dos_header =
+            reinterpret_cast<const IMAGE_DOS_HEADER *>(base);
+
+        return reinterpret_cast<const IMAGE_NT_HEADERS *>(
+            base + dos_header->e_lfanew);
+    }
+
+    // Search the executable sections of the loaded image
+    std::uintptr_t find_in_image(
+        std::uintptr_t            base,
+        const cyanide::signature &sig)
+    {
+        const IMAGE_NT_HEADERS     *headers = nt_headers(base);
+        const IMAGE_SECTION_HEADER *section = IMAGE_FIRST_SECTION(headers);
+
+        for (WORD i = 0; i < headers->FileHeader.NumberOfSections;
+             ++i, ++section)
+        {
+            if ((section->Characteristics & IMAGE_SCN_MEM_EXECUTE) == 0)
+                continue;
+
+            const std::span<const cyanide::byte_t> data{
+                reinterpret_cast<const cyanide::byte_t *>(
+                    base + section->VirtualAddress),
+                section->Misc.VirtualSize};
+
+            if (const cyanide::byte_t *match = cyanide::find_pattern(data, sig))
+                return reinterpret_cast<std::uintptr_t>(match);
+        }
+
+        throw std::runtime_error{"Signature of the deferred hook not found"};
+    }
+} // namespace
+
+deferred_hooks::deferred_hooks(std::function<void(std::exception_ptr)> on_error)
+    : on_error_{std::move(on_error)}
+{
+    const auto register_notification =
+        ntdll_function<register_notification_t>("LdrRegisterDllNotification");
+
+    const LONG status = register_notification(
+        0,
+        &deferred_hooks::notification,
+        this,
+        &cookie_);
+
+    if (status < 0)
+    {
+        throw std::runtime_error{
+            "LdrRegisterDllNotification failed with status "
+            + std::to_string(status)};
+    }
+}
+
+deferred_hooks::~deferred_hooks()
+{
+    // No notifications past this point, the hooks are uninstalled by the
+    // entries destruction
+    ntdll_function<unregister_notification_t>("LdrUnregisterDllNotification")(
+        cookie_);
+}
+
+void deferred_hooks::add_installer(
+    std::string_view module,
+    location_t       location,
+    installer_t      installer)
+{
+    auto owned = std::make_unique<entry>(
+        entry{to_wide(module), std::move(location), std::move(installer)});
+
+    entry &target = *owned;
+
+    {
+        std::lock_guard lock{mutex_};
+        entries_.push_back(std::move(owned));
+    }
+
+    // Has to be done without holding the mutex - GetModuleHandleExW takes the
+    // loader lock, which is held by the notification waiting for the mutex.
+    // The reference keeps the module from being unloaded meanwhile.
+    HMODULE handle = nullptr;
+
+    if (GetModuleHandleExW(0, target.module.c_str(), &handle) == 0)
+        return;
+
+    const auto base = reinterpret_cast<std::uintptr_t>(handle);
+
+    try
+    {
+        std::lock_guard lock{mutex_};
+
+        // The notification may have got there first
+        if (!target.installed)
+        {
+            install(
+                target,
+                base,
+                nt_headers(base)->OptionalHeader.SizeOfImage);
+        }
+    }
+    catch (...)
+    {
+        FreeLibrary(handle);
+        throw;
+    }
+
+    FreeLibrary(handle);
+}
+
+std::size_t deferred_hooks::installed_count() const
+{
+    std::lock_guard lock{mutex_};
+
+    std::size_t count = 0;
+
+    for (const auto &current : entries_)
+    {
+        if (current->installed)
+            ++count;
+    }
+
+    return count;
+}
+
+void deferred_hooks::install(
+    entry         &target,
+    std::uintptr_t base,
+    std::size_t    size)
+{
+    std::uintptr_t address = 0;
+
+    if (const auto *offset = std::get_if<std::uintptr_t>(&target.location))
+    {
+        if (*offset >= size)
+            throw std::out_of_range{"Hook offset is out of the module"};
+
+        address = base + *offset;
+    }
+    else
+    {
+        address =
+            find_in_image(base, std::get<cyanide::signature>(target.location));
+    }
+
+    target.installed   = target.installer(reinterpret_cast<void *>(address));
+    target.module_base = base;
+}
+
+void deferred_hooks::on_loaded(
+    std::wstring_view module,
+    std::uintptr_t    base,
+    std::size_t       size)
+{
+    std::vector<std::exception_ptr> errors;
+
+    {
+        std::lock_guard lock{mutex_};
+
+        for (auto &current : entries_)
+        {
+            if (current->installed || !is_same_module(current->module, module))
+                continue;
+
+            try
+            {
+                install(*current, base, size);
+            }
+            catch (...)
+            {
+                errors.push_back(std::current_exception());
+            }
+        }
+    }
+
+    if (on_error_)
+    {
+        for (const auto &error : errors)
+            on_error_(error);
+    }
+}
+
+void deferred_hooks::on_unloaded(std::uintptr_t base)
+{
+    std::lock_guard lock{mutex_};
+
+    // The module is still mapped at this point, so the original bytes can be
+    // restored
+    for (auto &current : entries_)
+    {
+        if (current->installed && current->module_base == base)
+        {
+            current->installed.reset();
+            current->module_base = 0;
+        }
+    }
+}
+
+void __stdcall deferred_hooks::notification(
+    unsigned long reason,
+    const void   *data,
+    void         *context)
+{
+    auto       *self = static_cast<deferred_hooks *>(context);
+    const auto *info = static_cast<const dll_notification_data *>(data);
+
+    const auto base = reinterpret_cast<std::uintptr_t>(info->dll_base);
+
+    // Exceptions must not propagate into the loader, so on_error_ must not
+    // throw either
+    try
+    {
+        if (reason == notification_reason_loaded)
+        {
+            self->on_loaded(
+                {info->base_dll_name->buffer,
+                 info->base_dll_name->length / sizeof(wchar_t)},
+                base,
+                info->size_of_image);
+        }
+        else if (reason == notification_reason_unloaded)
+        {
+            self->on_unloaded(base);
+        }
+    }
+    catch (...)
+    {
+        if (self->on_error_)
+            self->on_error_(std::current_exception());
+    }
+}
+
+} // namespace cyanide
@@ -0,0 +1,138 @@
+#include <cyanide/hook_offload.hpp>
+
+#include <atomic> // std::atomic_thread_fence
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread> // std::jthread, std::stop_token, std::this_thread::yield
+
+namespace cyanide {
+
+hook_offload::hook_offload(
+    std::size_t             workers,
+    std::size_t             capacity,
+    cyanide::offload_policy policy,
+    std::uint32_t           sample_rate)
+    : queue_{capacity},
+      policy_{policy},
+      sample_rate_{sample_rate == 0 ? 1 : sample_rate}
+{
+    workers_.reserve(workers == 0 ? 1 : workers);
+
+    // Started last, when the rest of the object is ready
+    while (workers_.size() < workers_.capacity())
+    {
+        workers_.emplace_back([this](std::stop_token stop) {
+            run(stop);
+        });
+    }
+}
+
+hook_offload::~hook_offload()
+{
+    for (auto &worker : workers_)
+        worker.request_stop();
+
+    // Joins, the workers empty the queue before exiting
+    workers_.clear();
+}
+
+void hook_offload::submit(const cyanide::offload_task &task)
+{
+    switch (policy_)
+    {
+        case cyanide::offload_policy::drop:
+            if (!queue_.try_push(task))
+            {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            break;
+
+        case cyanide::offload_policy::block:
+            while (!queue_.try_push(task))
+            {
+                wakeup_.notify_all();
+                std::this_thread::yield();
+            }
+
+            break;
+
+        case cyanide::offload_policy::sample:
+        {
+            const bool under_pressure =
+                queue_.size() * 2 >= queue_.capacity();
+
+            // Per pool, the threads only contend on it under pressure
+            const bool skipped =
+                under_pressure
+                && (sample_counter_.fetch_add(1, std::memory_order_relaxed) + 1)
+                           % sample_rate_
+                       != 0;
+
+            if (skipped || !queue_.try_push(task))
+            {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            break;
+        }
+    }
+
+    /*
+     * Pairs with the fence in run(): either the worker going to sleep sees
+     * the task, or it's counted as idle here. The notification is sent under
+     * the lock, so it can't fall between the worker's check and its wait.
+     */
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (idle_workers_.load(std::memory_order_relaxed) != 0)
+    {
+        std::lock_guard lock{mutex_};
+        wakeup_.notify_one();
+    }
+}
+
+void hook_offload::wait() const
+{
+    const std::size_t target = queue_.pushed();
+
+    while (completed_.load(std::memory_order_acquire) < target)
+        std::this_thread::yield();
+}
+
+void hook_offload::run(std::stop_token stop)
+{
+    cyanide::offload_task task;
+
+    for (;;)
+    {
+        if (queue_.try_pop(task))
+        {
+            task.invoke(task.callback, task.args.data());
+            completed_.fetch_add(1, std::memory_order_release);
+
+            continue;
+        }
+
+        // The queue is empty, so nothing is left behind
+        if (stop.stop_requested())
+            break;
+
+        std::unique_lock lock{mutex_};
+
+        // Counted before the queue is checked, see submit()
+        idle_workers_.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        wakeup_.wait(lock, stop, [this] {
+            return queue_.size() != 0;
+        });
+
+        idle_workers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+} // namespace cyanide
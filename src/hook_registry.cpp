@@ -0,0 +1,308 @@
+#include <cyanide/hook_registry.hpp>
+#include <cyanide/patch.hpp>
+
+#include <algorithm> // std::lower_bound, std::upper_bound
+#include <cstddef>
+#include <cstdint>
+#include <memory> // std::make_shared, std::shared_ptr
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility> // std::move
+#include <vector>
+
+namespace cyanide {
+
+hook_registry::~hook_registry()
+{
+    // Uninstalls the hooks and reverts the patches
+    while (!ids_.empty())
+        remove(ids_.back());
+}
+
+hook_registry::id_t hook_registry::add_patch(
+    std::string                      name,
+    void                            *address,
+    std::span<const cyanide::byte_t> bytes,
+    bool                             unprotect)
+{
+    const auto begin = reinterpret_cast<std::uintptr_t>(address);
+
+    check_conflicts(begin, bytes.size());
+
+    return add_entry(
+        std::move(name),
+        cyanide::registry_entry_kind::patch,
+        begin,
+        bytes.size(),
+        std::make_shared<cyanide::patch<>>(address, bytes, unprotect),
+        nullptr);
+}
+
+void hook_registry::remove(id_t id)
+{
+    const auto slot = slot_of(id);
+
+    if (!slot)
+        return;
+
+    uninstall_slot(*slot);
+
+    const auto position =
+        static_cast<std::ptrdiff_t>(index_position(addresses_[*slot]));
+
+    index_addresses_.erase(index_addresses_.begin() + position);
+    index_slots_.erase(index_slots_.begin() + position);
+
+    // Swap with the last one, so that the columns stay contiguous
+    const auto last = static_cast<std::uint32_t>(ids_.size() - 1);
+
+    if (*slot != last)
+    {
+        ids_[*slot]       = ids_[last];
+        addresses_[*slot] = addresses_[last];
+        sizes_[*slot]     = sizes_[last];
+        kinds_[*slot]     = kinds_[last];
+        installed_[*slot] = installed_[last];
+        names_[*slot]     = std::move(names_[last]);
+        objects_[*slot]   = std::move(objects_[last]);
+        ops_[*slot]       = ops_[last];
+
+        index_slots_[index_position(addresses_[*slot])] = *slot;
+        slots_[ids_[*slot]]                             = *slot;
+    }
+
+    // Destroys the object, which reverts the patch
+    objects_.pop_back();
+
+    ids_.pop_back();
+    addresses_.pop_back();
+    sizes_.pop_back();
+    kinds_.pop_back();
+    installed_.pop_back();
+    names_.pop_back();
+    ops_.pop_back();
+
+    slots_.erase(id);
+}
+
+void hook_registry::install(id_t id)
+{
+    const auto slot = slot_of(id);
+
+    if (!slot)
+        throw std::out_of_range{"Unknown registry entry"};
+
+    if (installed_[*slot])
+        return;
+
+    ops_[*slot]->install(objects_[*slot].get());
+    installed_[*slot] = true;
+}
+
+void hook_registry::uninstall(id_t id)
+{
+    const auto slot = slot_of(id);
+
+    if (!slot)
+        throw std::out_of_range{"Unknown registry entry"};
+
+    if (kinds_[*slot] == cyanide::registry_entry_kind::hook)
+        uninstall_slot(*slot);
+}
+
+std::size_t hook_registry::install_all()
+{
+    std::vector<std::uint32_t> installed;
+
+    try
+    {
+        for (const std::uint32_t slot : index_slots_)
+        {
+            if (installed_[slot])
+                continue;
+
+            ops_[slot]->install(objects_[slot].get());
+            installed_[slot] = true;
+
+            installed.push_back(slot);
+        }
+    }
+    catch (...)
+    {
+        for (const std::uint32_t slot : installed)
+            uninstall_slot(slot);
+
+        throw;
+    }
+
+    return installed.size();
+}
+
+std::size_t hook_registry::uninstall_all()
+{
+    std::size_t count = 0;
+
+    for (std::uint32_t slot = 0; slot < ids_.size(); ++slot)
+    {
+        if (kinds_[slot] == cyanide::registry_entry_kind::hook
+            && installed_[slot])
+        {
+            uninstall_slot(slot);
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+std::optional<cyanide::registry_entry>
+hook_registry::find(const void *address) const
+{
+    const auto value = reinterpret_cast<std::uintptr_t>(address);
+
+    const auto it = std::upper_bound(
+        index_addresses_.begin(),
+        index_addresses_.end(),
+        value);
+
+    if (it == index_addresses_.begin())
+        return std::nullopt;
+
+    const auto position =
+        static_cast<std::size_t>(it - index_addresses_.begin()) - 1;
+    const std::uint32_t slot = index_slots_[position];
+
+    if (value - addresses_[slot] >= sizes_[slot])
+        return std::nullopt;
+
+    return make_entry(slot);
+}
+
+std::optional<cyanide::registry_entry> hook_registry::get(id_t id) const
+{
+    const auto slot = slot_of(id);
+
+    if (!slot)
+        return std::nullopt;
+
+    return make_entry(*slot);
+}
+
+std::vector<cyanide::registry_entry> hook_registry::entries() const
+{
+    std::vector<cyanide::registry_entry> result;
+    result.reserve(index_slots_.size());
+
+    for (const std::uint32_t slot : index_slots_)
+        result.push_back(make_entry(slot));
+
+    return result;
+}
+
+void hook_registry::check_conflicts(std::uintptr_t address, std::size_t size)
+    const
+{
+    if (size == 0)
+        throw std::invalid_argument{"Registry entry must not be empty"};
+
+    const std::size_t position = index_position(address);
+
+    // The ranges don't overlap each other, so only the neighbours can overlap
+    // with the new one
+    const auto conflict = [this](std::uint32_t slot) {
+        return std::invalid_argument{
+            "Range overlaps with registry entry \"" + names_[slot] + "\""};
+    };
+
+    if (position > 0)
+    {
+        const std::uint32_t previous = index_slots_[position - 1];
+
+        if (address - addresses_[previous] < sizes_[previous])
+            throw conflict(previous);
+    }
+
+    if (position < index_slots_.size()
+        && index_addresses_[position] - address < size)
+    {
+        throw conflict(index_slots_[position]);
+    }
+}
+
+hook_registry::id_t hook_registry::add_entry(
+    std::string                  name,
+    cyanide::registry_entry_kind kind,
+    std::uintptr_t               address,
+    std::size_t                  size,
+    std::shared_ptr<void>        object,
+    const entry_ops             *ops)
+{
+    check_conflicts(address, size);
+
+    const id_t id       = next_id_++;
+    const auto slot     = static_cast<std::uint32_t>(ids_.size());
+    const auto position =
+        static_cast<std::ptrdiff_t>(index_position(address));
+
+    ids_.push_back(id);
+    addresses_.push_back(address);
+    sizes_.push_back(static_cast<std::uint32_t>(size));
+    kinds_.push_back(kind);
+    installed_.push_back(kind == cyanide::registry_entry_kind::patch);
+    names_.push_back(std::move(name));
+    objects_.push_back(std::move(object));
+    ops_.push_back(ops);
+
+    index_addresses_.insert(index_addresses_.begin() + position, address);
+    index_slots_.insert(index_slots_.begin() + position, slot);
+
+    slots_.emplace(id, slot);
+
+    return id;
+}
+
+std::size_t hook_registry::index_position(std::uintptr_t address) const
+{
+    // The addresses are unique, as the ranges don't overlap, so this is also
+    // the insertion position
+    return static_cast<std::size_t>(
+        std::lower_bound(
+            index_addresses_.begin(),
+            index_addresses_.end(),
+            address)
+        - index_addresses_.begin());
+}
+
+cyanide::registry_entry hook_registry::make_entry(std::uint32_t slot) const
+{
+    return {
+        ids_[slot],
+        kinds_[slot],
+        addresses_[slot],
+        sizes_[slot],
+        names_[slot],
+        installed_[slot] != 0};
+}
+
+std::optional<std::uint32_t> hook_registry::slot_of(id_t id) const
+{
+    const auto it = slots_.find(id);
+
+    if (it == slots_.end())
+        return std::nullopt;
+
+    return it->second;
+}
+
+void hook_registry::uninstall_slot(std::uint32_t slot)
+{
+    if (kinds_[slot] != cyanide::registry_entry_kind::hook || !installed_[slot])
+        return;
+
+    ops_[slot]->uninstall(objects_[slot].get());
+    installed_[slot] = false;
+}
+
+} // namespace cyanide
@@ -0,0 +1,210 @@
+#if !defined _WIN32
+    #error "Unsupported platform"
+#endif
+
+#include <cyanide/hook_tracer.hpp>
+
+#include <Windows.h>
+#include <intrin.h> // __rdtsc
+
+#include <algorithm> // std::find_if, std::iter_swap
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <iterator> // std::prev
+#include <memory> // std::make_shared, std::shared_ptr
+#include <mutex>
+#include <stdexcept>
+#include <thread> // std::jthread, std::stop_token
+#include <utility> // std::move, std::pair
+#include <vector>  // std::erase, std::erase_if
+
+namespace cyanide {
+
+namespace {
+    std::atomic<std::uint64_t> next_generation = 1;
+} // namespace
+
+hook_tracer::hook_tracer(
+    const std::filesystem::path &path,
+    std::size_t                  ring_capacity,
+    std::chrono::milliseconds    interval)
+    : ring_capacity_{ring_capacity},
+      interval_{interval},
+      generation_{next_generation.fetch_add(1, std::memory_order_relaxed)},
+      file_{path, std::ios::binary | std::ios::trunc}
+{
+    if (!file_)
+        throw std::runtime_error{"Failed to open the trace file"};
+
+    const std::uint32_t header[] = {
+        magic,
+        version,
+        static_cast<std::uint32_t>(sizeof(cyanide::trace_event))};
+
+    file_.write(reinterpret_cast<const char *>(header), sizeof(header));
+
+    if (!file_)
+        throw std::runtime_error{"Failed to write the trace file header"};
+
+    // Started last, when the rest of the object is ready
+    thread_ = std::jthread{[this](std::stop_token stop) {
+        run(stop);
+    }};
+}
+
+hook_tracer::~hook_tracer()
+{
+    thread_.request_stop();
+    thread_.join();
+
+    flush();
+}
+
+void hook_tracer::record(cyanide::trace_event event)
+{
+    thread_local const std::uint32_t thread_id = GetCurrentThreadId();
+
+    event.timestamp = __rdtsc();
+    event.thread_id = thread_id;
+
+    thread_ring &current = current_ring();
+
+    if (!current.ring.try_push(event))
+        current.dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::size_t hook_tracer::flush()
+{
+    std::lock_guard flush_lock{flush_mutex_};
+
+    // The rings nobody else owns belong to the exited threads, they are
+    // drained for the last time and retired
+    std::vector<std::pair<std::shared_ptr<thread_ring>, bool>> rings;
+
+    {
+        std::lock_guard lock{mutex_};
+
+        rings.reserve(rings_.size());
+
+        for (const auto &current : rings_)
+            rings.emplace_back(current, current.use_count() == 1);
+    }
+
+    batch_.clear();
+
+    for (const auto &[current, orphaned] : rings)
+        current->ring.drain(batch_);
+
+    file_.write(
+        reinterpret_cast<const char *>(batch_.data()),
+        static_cast<std::streamsize>(
+            batch_.size() * sizeof(cyanide::trace_event)));
+    file_.flush();
+
+    // E.g. the disk is full, the stream stays failed and so do the next
+    // flushes. Whatever part made it to the file is unknown, the whole batch
+    // is counted as lost.
+    const bool written = static_cast<bool>(file_);
+
+    {
+        std::lock_guard lock{mutex_};
+
+        if (!written)
+            unwritten_ += batch_.size();
+
+        for (const auto &[current, orphaned] : rings)
+        {
+            if (!orphaned)
+                continue;
+
+            retired_dropped_ +=
+                current->dropped.load(std::memory_order_relaxed);
+            std::erase(rings_, current);
+        }
+    }
+
+    return written ? batch_.size() : 0;
+}
+
+std::size_t hook_tracer::ring_count() const
+{
+    std::lock_guard lock{mutex_};
+
+    return rings_.size();
+}
+
+std::uint64_t hook_tracer::dropped() const
+{
+    std::lock_guard lock{mutex_};
+
+    std::uint64_t result = retired_dropped_ + unwritten_;
+
+    for (const auto &current : rings_)
+        result += current->dropped.load(std::memory_order_relaxed);
+
+    return result;
+}
+
+hook_tracer::thread_ring &hook_tracer::current_ring()
+{
+    // Rings of the thread, one per tracer and kept for the thread lifetime.
+    // The last used one goes first, so a single tracer costs one comparison.
+    thread_local std::vector<
+        std::pair<std::uint64_t, std::shared_ptr<thread_ring>>>
+        cached;
+
+    if (!cached.empty() && cached.front().first == generation_)
+        return *cached.front().second;
+
+    auto it = std::find_if(
+        cached.begin(),
+        cached.end(),
+        [this](const auto &entry) {
+            return entry.first == generation_;
+        });
+
+    if (it == cached.end())
+    {
+        // Nobody else holds the rings of the destroyed tracers
+        std::erase_if(cached, [](const auto &entry) {
+            return entry.second.use_count() == 1;
+        });
+
+        auto created = std::make_shared<thread_ring>(ring_capacity_);
+
+        {
+            std::lock_guard lock{mutex_};
+            rings_.push_back(created);
+        }
+
+        cached.emplace_back(generation_, std::move(created));
+        it = std::prev(cached.end());
+    }
+
+    std::iter_swap(cached.begin(), it);
+
+    return *cached.front().second;
+}
+
+void hook_tracer::run(std::stop_token stop)
+{
+    while (!stop.stop_requested())
+    {
+        {
+            std::unique_lock lock{flush_mutex_};
+
+            // Only the stop request wakes the thread up early
+            wakeup_.wait_for(lock, stop, interval_, [] { return false; });
+        }
+
+        if (stop.stop_requested())
+            break;
+
+        flush();
+    }
+}
+
+} // namespace cyanide
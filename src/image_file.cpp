@@ -0,0 +1,273 @@
+#include <cyanide/image_file.hpp>
+#include <cyanide/safe_pun.hpp>
+#include <cyanide/scanner.hpp>
+
+#include <algorithm> // std::min
+#include <cstddef>
+#include <cstdint>
+#include <cstring> // std::memcmp, std::strlen
+#include <limits>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility> // std::move
+#include <vector>
+
+namespace cyanide {
+
+namespace {
+    // Bounds-checked read of the header field
+    template <typename T>
+    T read_field(std::span<const cyanide::byte_t> image, std::uint64_t offset)
+    {
+        if (offset > image.size() || image.size() - offset < sizeof(T))
+            throw std::runtime_error{"Malformed image - header out of bounds"};
+
+        return cyanide::safe_pun<T>(image.data() + offset);
+    }
+
+    std::span<const cyanide::byte_t> sub_image(
+        std::span<const cyanide::byte_t> image,
+        std::uint64_t                    offset,
+        std::uint64_t                    size)
+    {
+        if (offset > image.size() || image.size() - offset < size)
+            throw std::runtime_error{"Malformed image - section out of bounds"};
+
+        return image.subspan(
+            static_cast<std::size_t>(offset),
+            static_cast<std::size_t>(size));
+    }
+
+    constexpr std::uint16_t pe32_magic      = 0x10B;
+    constexpr std::uint16_t pe32_plus_magic = 0x20B;
+
+    constexpr std::uint8_t  elf_class_32   = 1;
+    constexpr std::uint8_t  elf_class_64   = 2;
+    constexpr std::uint8_t  elf_data_lsb   = 1;
+    constexpr std::uint32_t elf_pt_load    = 1;
+    constexpr std::uint32_t elf_sht_nobits = 8;
+    constexpr std::uint64_t elf_shf_alloc  = 0x2;
+} // namespace
+
+image_file::image_file(std::span<const cyanide::byte_t> image) : image_{image}
+{
+    constexpr cyanide::byte_t elf_magic[] = {0x7F, 'E', 'L', 'F'};
+
+    if (image_.size() >= 2 && image_[0] == 'M' && image_[1] == 'Z')
+    {
+        format_ = cyanide::image_format::pe;
+        parse_pe();
+    }
+    else if (
+        image_.size() >= sizeof(elf_magic)
+        && std::memcmp(image_.data(), elf_magic, sizeof(elf_magic)) == 0)
+    {
+        format_ = cyanide::image_format::elf;
+        parse_elf();
+    }
+    else
+    {
+        throw std::runtime_error{"Unknown image format"};
+    }
+}
+
+void image_file::parse_pe()
+{
+    const auto pe_offset = read_field<std::uint32_t>(image_, 0x3C);
+
+    if (read_field<std::uint32_t>(image_, pe_offset) != 0x00004550) // PE\0\0
+        throw std::runtime_error{"Malformed image - no PE signature"};
+
+    const std::uint64_t coff_header = pe_offset + 4;
+    const auto sections_count = read_field<std::uint16_t>(image_, coff_header + 2);
+    const auto optional_header_size =
+        read_field<std::uint16_t>(image_, coff_header + 16);
+
+    const std::uint64_t optional_header = coff_header + 20;
+
+    switch (read_field<std::uint16_t>(image_, optional_header))
+    {
+        case pe32_magic:
+            image_base_ = read_field<std::uint32_t>(image_, optional_header + 28);
+            break;
+
+        case pe32_plus_magic:
+            image_base_ = read_field<std::uint64_t>(image_, optional_header + 24);
+            break;
+
+        default:
+            throw std::runtime_error{"Malformed image - unknown PE magic"};
+    }
+
+    const std::uint64_t section_table = optional_header + optional_header_size;
+
+    for (std::uint16_t i = 0; i < sections_count; ++i)
+    {
+        const std::uint64_t header = section_table + i * 40ULL;
+
+        const auto name_bytes = sub_image(image_, header, 8);
+        const auto virtual_size = read_field<std::uint32_t>(image_, header + 8);
+        const auto rva          = read_field<std::uint32_t>(image_, header + 12);
+        const auto raw_size     = read_field<std::uint32_t>(image_, header + 16);
+        const auto raw_offset   = read_field<std::uint32_t>(image_, header + 20);
+
+        // Raw data is padded to the file alignment, don't scan the padding
+        const std::uint32_t size =
+            virtual_size != 0 ? std::min(virtual_size, raw_size) : raw_size;
+
+        std::string name{
+            reinterpret_cast<const char *>(name_bytes.data()),
+            name_bytes.size()};
+        name.resize(std::strlen(name.c_str()));
+
+        sections_.push_back(
+            {std::move(name), rva, sub_image(image_, raw_offset, size)});
+    }
+}
+
+void image_file::parse_elf()
+{
+    const auto elf_class = read_field<std::uint8_t>(image_, 4);
+
+    if (read_field<std::uint8_t>(image_, 5) != elf_data_lsb)
+        throw std::runtime_error{"Big-endian ELF images are not supported"};
+
+    if (elf_class != elf_class_32 && elf_class != elf_class_64)
+        throw std::runtime_error{"Malformed image - unknown ELF class"};
+
+    const bool is_64 = elf_class == elf_class_64;
+
+    // Read the field which is 4 bytes wide in ELF32 and 8 bytes wide in ELF64
+    const auto read_word = [this, is_64](std::uint64_t offset) -> std::uint64_t {
+        return is_64 ? read_field<std::uint64_t>(image_, offset)
+                     : read_field<std::uint32_t>(image_, offset);
+    };
+
+    const std::uint64_t ph_offset = read_word(is_64 ? 32 : 28);
+    const std::uint64_t sh_offset = read_word(is_64 ? 40 : 32);
+    const auto ph_size  = read_field<std::uint16_t>(image_, is_64 ? 54 : 42);
+    const auto ph_count = read_field<std::uint16_t>(image_, is_64 ? 56 : 44);
+    const auto sh_size  = read_field<std::uint16_t>(image_, is_64 ? 58 : 46);
+    const auto sh_count = read_field<std::uint16_t>(image_, is_64 ? 60 : 48);
+    const auto sh_names = read_field<std::uint16_t>(image_, is_64 ? 62 : 50);
+
+    // Image base is the lowest address of the loadable segments
+    std::uint64_t lowest_address = std::numeric_limits<std::uint64_t>::max();
+
+    for (std::uint16_t i = 0; i < ph_count; ++i)
+    {
+        const std::uint64_t header = ph_offset + i * std::uint64_t{ph_size};
+
+        if (read_field<std::uint32_t>(image_, header) != elf_pt_load)
+            continue;
+
+        lowest_address =
+            std::min(lowest_address, read_word(header + (is_64 ? 16 : 8)));
+    }
+
+    image_base_ = lowest_address == std::numeric_limits<std::uint64_t>::max()
+                    ? 0
+                    : lowest_address & ~std::uint64_t{0xFFF};
+
+    if (sh_count == 0)
+        return;
+
+    const auto section_header = [&](std::uint16_t index) {
+        return sh_offset + index * std::uint64_t{sh_size};
+    };
+
+    const std::uint64_t names_header = section_header(sh_names);
+    const std::uint64_t names_offset =
+        read_word(names_header + (is_64 ? 24 : 16));
+    const std::uint64_t names_size = read_word(names_header + (is_64 ? 32 : 20));
+    const auto          names = sub_image(image_, names_offset, names_size);
+
+    for (std::uint16_t i = 0; i < sh_count; ++i)
+    {
+        const std::uint64_t header = section_header(i);
+
+        const auto name_offset = read_field<std::uint32_t>(image_, header);
+        const auto type        = read_field<std::uint32_t>(image_, header + 4);
+        const std::uint64_t flags   = read_word(header + 8);
+        const std::uint64_t address = read_word(header + (is_64 ? 16 : 12));
+        const std::uint64_t offset  = read_word(header + (is_64 ? 24 : 16));
+        const std::uint64_t size    = read_word(header + (is_64 ? 32 : 20));
+
+        // Only sections that are present both in memory and in the file
+        if ((flags & elf_shf_alloc) == 0 || type == elf_sht_nobits)
+            continue;
+
+        std::string name;
+
+        if (name_offset < names.size())
+        {
+            const std::string_view all_names{
+                reinterpret_cast<const char *>(names.data()),
+                names.size()};
+
+            name = all_names.substr(
+                name_offset,
+                all_names.find('\0', name_offset) - name_offset);
+        }
+
+        sections_.push_back(
+            {std::move(name),
+             address - image_base_,
+             sub_image(image_, offset, size)});
+    }
+}
+
+std::optional<std::uint64_t>
+image_file::offset_to_rva(std::uint64_t file_offset) const noexcept
+{
+    for (const auto &section : sections_)
+    {
+        const auto begin = static_cast<std::uint64_t>(
+            section.data.data() - image_.data());
+
+        if (file_offset >= begin && file_offset - begin < section.data.size())
+            return section.rva + (file_offset - begin);
+    }
+
+    return std::nullopt;
+}
+
+std::optional<std::uint64_t>
+image_file::find_pattern(const cyanide::signature &sig) const
+{
+    for (const auto &section : sections_)
+    {
+        if (const cyanide::byte_t *match =
+                cyanide::find_pattern(section.data, sig))
+        {
+            return section.rva
+                 + static_cast<std::uint64_t>(match - section.data.data());
+        }
+    }
+
+    return std::nullopt;
+}
+
+std::vector<std::uint64_t>
+image_file::find_all_patterns(const cyanide::signature &sig) const
+{
+    std::vector<std::uint64_t> matches;
+
+    for (const auto &section : sections_)
+    {
+        for (const cyanide::byte_t *match :
+             cyanide::find_all_patterns(section.data, sig))
+        {
+            matches.push_back(
+                section.rva
+                + static_cast<std::uint64_t>(match - section.data.data()));
+        }
+    }
+
+    return matches;
+}
+
+} // namespace cyanide
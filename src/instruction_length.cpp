@@ -0,0 +1,343 @@
+#include <cyanide/instruction_length.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <span>
+
+namespace cyanide {
+
+namespace {
+    constexpr std::size_t max_instruction_length = 15;
+
+    // Operand layout of an opcode
+    enum operand_flags : std::uint8_t {
+        has_modrm = 1 << 0,
+        imm8      = 1 << 1,
+        imm16     = 1 << 2,
+        imm_z     = 1 << 3, // 2 or 4 bytes, by the operand size
+        far_ptr   = 1 << 4, // imm_z and the 2-byte segment
+        moffs     = 1 << 5, // 2 or 4 bytes, by the address size
+        group3    = 1 << 6  // Immediate only for /0 and /1 (test)
+    };
+
+    using opcode_table = std::array<std::uint8_t, 256>;
+
+    consteval void set(
+        opcode_table                       &table,
+        std::initializer_list<std::uint8_t> opcodes,
+        std::uint8_t                        flags)
+    {
+        for (const std::uint8_t opcode : opcodes)
+            table[opcode] |= flags;
+    }
+
+    consteval void set_range(
+        opcode_table &table,
+        unsigned      first,
+        unsigned      last,
+        std::uint8_t  flags)
+    {
+        for (unsigned opcode = first; opcode <= last; ++opcode)
+            table[opcode] |= flags;
+    }
+
+    consteval opcode_table make_one_byte_table()
+    {
+        opcode_table table{};
+
+        // ALU rows: r/m forms take ModRM, then AL/eAX with an immediate
+        for (unsigned row = 0; row < 0x40; row += 8)
+        {
+            set_range(table, row, row + 3, has_modrm);
+            table[row + 4] |= imm8;
+            table[row + 5] |= imm_z;
+        }
+
+        set(table, {0x62, 0x63, 0x69, 0x6B}, has_modrm);
+        set(table, {0x68, 0x69}, imm_z);
+        set(table, {0x6A, 0x6B}, imm8);
+        set_range(table, 0x70, 0x7F, imm8);
+
+        set_range(table, 0x80, 0x8F, has_modrm);
+        set(table, {0x80, 0x82, 0x83}, imm8);
+        set(table, {0x81}, imm_z);
+
+        set(table, {0x9A, 0xEA}, far_ptr);
+        set_range(table, 0xA0, 0xA3, moffs);
+        set(table, {0xA8}, imm8);
+        set(table, {0xA9}, imm_z);
+        set_range(table, 0xB0, 0xB7, imm8);
+        set_range(table, 0xB8, 0xBF, imm_z);
+
+        set(table, {0xC0, 0xC1, 0xC4, 0xC5, 0xC6, 0xC7}, has_modrm);
+        set(table, {0xC0, 0xC1, 0xC6, 0xCD}, imm8);
+        set(table, {0xC7}, imm_z);
+        set(table, {0xC2, 0xCA}, imm16);
+        set(table, {0xC8}, imm16 | imm8);
+
+        set_range(table, 0xD0, 0xD3, has_modrm);
+        set(table, {0xD4, 0xD5}, imm8);
+        set_range(table, 0xD8, 0xDF, has_modrm); // x87
+
+        set_range(table, 0xE0, 0xE7, imm8);
+        set(table, {0xE8, 0xE9}, imm_z);
+        set(table, {0xEB}, imm8);
+
+        set(table, {0xF6, 0xF7, 0xFE, 0xFF}, has_modrm);
+        set(table, {0xF6}, group3 | imm8);
+        set(table, {0xF7}, group3 | imm_z);
+
+        return table;
+    }
+
+    consteval opcode_table make_two_byte_table()
+    {
+        opcode_table table{};
+
+        set_range(table, 0x00, 0xFF, has_modrm);
+
+        // The ones without ModRM: system instructions, jcc rel32, push / pop
+        // fs / gs, cpuid, rsm and bswap
+        const auto clear = [&table](unsigned first, unsigned last) {
+            for (unsigned opcode = first; opcode <= last; ++opcode)
+                table[opcode] = 0;
+        };
+
+        clear(0x05, 0x09);
+        clear(0x0B, 0x0B);
+        clear(0x0E, 0x0E);
+        clear(0x30, 0x37);
+        clear(0x77, 0x77);
+        clear(0x80, 0x8F);
+        clear(0xA0, 0xA2);
+        clear(0xA8, 0xAA);
+        clear(0xC8, 0xCF);
+
+        // 0F 0F is 3DNow!, its opcode follows the operands as an imm8
+        set(table, {0x0F, 0x70, 0x71, 0x72, 0x73, 0xA4, 0xAC, 0xBA}, imm8);
+        set(table, {0xC2, 0xC4, 0xC5, 0xC6}, imm8);
+        set_range(table, 0x80, 0x8F, imm_z);
+
+        return table;
+    }
+
+    constexpr opcode_table one_byte_table = make_one_byte_table();
+    constexpr opcode_table two_byte_table = make_two_byte_table();
+
+    constexpr bool is_prefix(cyanide::byte_t value) noexcept
+    {
+        switch (value)
+        {
+            case 0x26:
+            case 0x2E:
+            case 0x36:
+            case 0x3E:
+            case 0x64:
+            case 0x65:
+            case 0x66:
+            case 0x67:
+            case 0xF0:
+            case 0xF2:
+            case 0xF3:
+                return true;
+
+            default:
+                return false;
+        }
+    }
+
+    // Bounds-checked reader of the instruction bytes
+    class cursor {
+    public:
+        explicit cursor(std::span<const cyanide::byte_t> code) noexcept
+            : code_{code}
+        {}
+
+        // Zero past the end, valid() tells it apart
+        cyanide::byte_t next() noexcept
+        {
+            const cyanide::byte_t value =
+                position_ < code_.size() ? code_[position_] : 0;
+
+            ++position_;
+
+            return value;
+        }
+
+        cyanide::byte_t peek() const noexcept
+        {
+            return position_ < code_.size() ? code_[position_] : 0;
+        }
+
+        void skip(std::size_t count) noexcept
+        {
+            position_ += count;
+        }
+
+        [[nodiscard]] bool valid() const noexcept
+        {
+            return position_ <= code_.size()
+                && position_ <= max_instruction_length;
+        }
+
+        [[nodiscard]] std::size_t position() const noexcept
+        {
+            return position_;
+        }
+
+    private:
+        std::span<const cyanide::byte_t> code_;
+        std::size_t                      position_ = 0;
+    };
+
+    // ModRM, SIB and the displacement, the ModRM byte is consumed
+    void skip_modrm(cursor &code, bool address_size_16) noexcept
+    {
+        const cyanide::byte_t modrm = code.next();
+
+        const unsigned mod = modrm >> 6;
+        const unsigned rm  = modrm & 7;
+
+        if (mod == 3)
+            return;
+
+        if (address_size_16)
+        {
+            if (mod == 1)
+                code.skip(1);
+            else if (mod == 2 || rm == 6)
+                code.skip(2);
+
+            return;
+        }
+
+        if (rm == 4)
+        {
+            const cyanide::byte_t sib = code.next();
+
+            if (mod == 0 && (sib & 7) == 5)
+                code.skip(4);
+        }
+
+        if (mod == 1)
+            code.skip(1);
+        else if (mod == 2 || (mod == 0 && rm == 5))
+            code.skip(4);
+    }
+
+    // Immediate of the VEX / EVEX instruction of the opcode map
+    bool vex_has_imm8(unsigned map, cyanide::byte_t opcode) noexcept
+    {
+        return map == 3 || (map == 1 && (two_byte_table[opcode] & imm8) != 0);
+    }
+} // namespace
+
+std::size_t instruction_length(std::span<const cyanide::byte_t> code) noexcept
+{
+    cursor current{code};
+
+    bool operand_size_16 = false;
+    bool address_size_16 = false;
+
+    while (current.valid() && is_prefix(current.peek()))
+    {
+        const cyanide::byte_t prefix = current.next();
+
+        operand_size_16 |= prefix == 0x66;
+        address_size_16 |= prefix == 0x67;
+    }
+
+    const std::size_t size_z = operand_size_16 ? 2 : 4;
+
+    const cyanide::byte_t opcode = current.next();
+
+    std::uint8_t flags = 0;
+
+    // VEX (C4, C5) and EVEX (62) are LES, LDS and BOUND in 32-bit mode unless
+    // the next byte would be a register ModRM, which these can't have
+    const bool vex_form = (opcode == 0xC4 || opcode == 0xC5 || opcode == 0x62)
+                       && (current.peek() & 0xC0) == 0xC0;
+
+    if (vex_form)
+    {
+        unsigned map = 1;
+
+        if (opcode == 0xC5)
+        {
+            current.skip(1);
+        }
+        else
+        {
+            map = current.next() & (opcode == 0x62 ? 0x03 : 0x1F);
+            current.skip(opcode == 0x62 ? 2 : 1);
+        }
+
+        const cyanide::byte_t vex_opcode = current.next();
+
+        // vzeroupper / vzeroall are the only ones without ModRM
+        if (map != 1 || vex_opcode != 0x77)
+            skip_modrm(current, address_size_16);
+
+        if (vex_has_imm8(map, vex_opcode))
+            current.skip(1);
+
+        return current.valid() ? current.position() : 0;
+    }
+
+    if (opcode == 0x0F)
+    {
+        const cyanide::byte_t second = current.next();
+
+        if (second == 0x38 || second == 0x3A)
+        {
+            current.skip(1);
+            skip_modrm(current, address_size_16);
+
+            if (second == 0x3A)
+                current.skip(1);
+
+            return current.valid() ? current.position() : 0;
+        }
+
+        flags = two_byte_table[second];
+    }
+    else
+    {
+        flags = one_byte_table[opcode];
+    }
+
+    bool immediate = true;
+
+    if ((flags & has_modrm) != 0)
+    {
+        // test r/m, imm is /0 and /1, the rest of the group have none
+        if ((flags & group3) != 0)
+            immediate = ((current.peek() >> 3) & 7) < 2;
+
+        skip_modrm(current, address_size_16);
+    }
+
+    if (immediate)
+    {
+        if ((flags & imm8) != 0)
+            current.skip(1);
+
+        if ((flags & imm16) != 0)
+            current.skip(2);
+
+        if ((flags & imm_z) != 0)
+            current.skip(size_z);
+
+        if ((flags & far_ptr) != 0)
+            current.skip(size_z + 2);
+
+        if ((flags & moffs) != 0)
+            current.skip(address_size_16 ? 2 : 4);
+    }
+
+    return current.valid() ? current.position() : 0;
+}
+
+} // namespace cyanide
@@ -0,0 +1,322 @@
+#if !defined _WIN32
+    #error "Unsupported platform"
+#endif
+
+#include <cyanide/code_patch.hpp>
+#include <cyanide/detail/crc32c.hpp>
+#include <cyanide/instruction_length.hpp>
+#include <cyanide/integrity_monitor.hpp>
+
+#include <Windows.h>
+
+#include <algorithm> // std::equal, std::sort, std::unique, std::min
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring> // std::memcmp
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <thread> // std::jthread, std::stop_token
+#include <utility> // std::exchange, std::move, std::swap
+#include <vector> // std::erase_if
+
+namespace cyanide {
+
+namespace {
+    constexpr std::uintptr_t page_size = 0x1000;
+
+    constexpr std::size_t max_instruction_length = 15;
+
+    bool is_nop(const cyanide::byte_t *code, std::size_t length) noexcept
+    {
+        return length <= cyanide::nop_forms.size()
+            && std::equal(
+                   code,
+                   code + length,
+                   cyanide::nop_forms[length - 1].begin());
+    }
+
+    constexpr std::uintptr_t page_of(std::uintptr_t address) noexcept
+    {
+        return address & ~(page_size - 1);
+    }
+} // namespace
+
+integrity_monitor::watch_handle::watch_handle(
+    integrity_monitor *monitor,
+    std::uint64_t      id) noexcept
+    : monitor_{monitor},
+      id_{id}
+{}
+
+integrity_monitor::watch_handle::~watch_handle()
+{
+    // The object seems to be moved-from
+    if (!monitor_)
+        return;
+
+    monitor_->unwatch(id_);
+}
+
+integrity_monitor::watch_handle::watch_handle(watch_handle &&other) noexcept
+    : monitor_{std::exchange(other.monitor_, nullptr)},
+      id_{std::exchange(other.id_, 0)}
+{}
+
+integrity_monitor::watch_handle &
+integrity_monitor::watch_handle::operator=(watch_handle &&other) noexcept
+{
+    watch_handle tmp{std::move(other)};
+
+    using std::swap;
+    swap(tmp, *this);
+
+    return *this;
+}
+
+void swap(
+    integrity_monitor::watch_handle &lhs,
+    integrity_monitor::watch_handle &rhs) noexcept
+{
+    using std::swap;
+
+    swap(lhs.monitor_, rhs.monitor_);
+    swap(lhs.id_, rhs.id_);
+}
+
+integrity_monitor::integrity_monitor(
+    callback_t                on_violation,
+    std::chrono::milliseconds interval)
+    : on_violation_{std::move(on_violation)},
+      interval_{interval}
+{
+    // Started last, when the rest of the object is ready
+    thread_ = std::jthread{[this](std::stop_token stop) {
+        run(stop);
+    }};
+}
+
+integrity_monitor::~integrity_monitor()
+{
+    thread_.request_stop();
+    thread_.join();
+}
+
+integrity_monitor::watch_handle
+integrity_monitor::watch(const void *address, std::size_t size)
+{
+    if (size == 0)
+        throw std::invalid_argument{"Watched range must not be empty"};
+
+    const auto  begin = reinterpret_cast<std::uintptr_t>(address);
+    const auto *bytes = static_cast<const cyanide::byte_t *>(address);
+
+    std::lock_guard lock{mutex_};
+
+    const std::uint64_t id = next_id_++;
+
+    sites_.emplace(id, site{begin, {bytes, bytes + size}});
+
+    for (std::uintptr_t current = begin; current < begin + size;)
+    {
+        const std::uintptr_t next =
+            std::min(begin + size, page_of(current) + page_size);
+
+        page &target = pages_[page_of(current)];
+
+        target.parts.push_back(
+            {id,
+             current,
+             static_cast<std::size_t>(next - current),
+             static_cast<std::size_t>(current - begin)});
+
+        update_checksum(target);
+
+        current = next;
+    }
+
+    return watch_handle{this, id};
+}
+
+std::size_t integrity_monitor::check()
+{
+    std::vector<cyanide::integrity_violation> violations;
+
+    {
+        std::lock_guard lock{mutex_};
+
+        const auto is_intact = [](const site &current) {
+            return std::memcmp(
+                       reinterpret_cast<const void *>(current.address),
+                       current.expected.data(),
+                       current.expected.size())
+                == 0;
+        };
+
+        std::vector<std::uint64_t> suspects;
+
+        for (auto &[base, current] : pages_)
+        {
+            std::uint32_t checksum = 0;
+
+            for (const auto &part : current.parts)
+            {
+                checksum = cyanide::detail::crc32c(
+                    {reinterpret_cast<const cyanide::byte_t *>(part.address),
+                     part.size},
+                    checksum);
+            }
+
+            if (checksum != current.checksum)
+            {
+                current.diverged = true;
+
+                for (const auto &part : current.parts)
+                    suspects.push_back(part.id);
+            }
+            else if (current.diverged)
+            {
+                // Restored since the last pass, so that the next overwrite is
+                // reported again
+                for (const auto &part : current.parts)
+                {
+                    site &restored = sites_.at(part.id);
+
+                    if (restored.violated && is_intact(restored))
+                        restored.violated = false;
+                }
+
+                current.diverged = false;
+            }
+        }
+
+        std::sort(suspects.begin(), suspects.end());
+        suspects.erase(
+            std::unique(suspects.begin(), suspects.end()),
+            suspects.end());
+
+        for (const std::uint64_t id : suspects)
+        {
+            site &suspect = sites_.at(id);
+
+            const bool intact = is_intact(suspect);
+
+            if (!intact && !suspect.violated)
+                violations.push_back({suspect.address, suspect.expected});
+
+            suspect.violated = !intact;
+        }
+    }
+
+    // Outside of the lock, so that the callback may unwatch the ranges
+    for (const auto &violation : violations)
+        on_violation_(violation);
+
+    return violations.size();
+}
+
+std::size_t integrity_monitor::size() const
+{
+    std::lock_guard lock{mutex_};
+
+    return sites_.size();
+}
+
+std::size_t integrity_monitor::detour_size(const void *source)
+{
+    const auto *code = static_cast<const cyanide::byte_t *>(source);
+
+    // The last overwritten instruction started within the jmp
+    constexpr std::size_t max_size =
+        hook_detour_size - 1 + max_instruction_length;
+
+    std::size_t size = cyanide::instruction_boundary(source, hook_detour_size);
+
+    while (size < max_size)
+    {
+        const std::size_t length = cyanide::instruction_length(
+            std::span{code + size, max_instruction_length});
+
+        if (length == 0 || length > max_size - size
+            || !is_nop(code + size, length))
+        {
+            break;
+        }
+
+        size += length;
+    }
+
+    return size;
+}
+
+void integrity_monitor::unwatch(std::uint64_t id)
+{
+    std::lock_guard lock{mutex_};
+
+    const auto it = sites_.find(id);
+
+    if (it == sites_.end())
+        return;
+
+    const std::uintptr_t begin = it->second.address;
+    const std::uintptr_t end   = begin + it->second.expected.size();
+
+    for (std::uintptr_t base = page_of(begin); base < end; base += page_size)
+    {
+        const auto page_it = pages_.find(base);
+
+        if (page_it == pages_.end())
+            continue;
+
+        std::erase_if(page_it->second.parts, [id](const site_part &part) {
+            return part.id == id;
+        });
+
+        if (page_it->second.parts.empty())
+            pages_.erase(page_it);
+        else
+            update_checksum(page_it->second);
+    }
+
+    sites_.erase(it);
+}
+
+void integrity_monitor::update_checksum(page &current) const
+{
+    std::uint32_t checksum = 0;
+
+    for (const auto &part : current.parts)
+    {
+        const site &owner = sites_.at(part.id);
+
+        checksum = cyanide::detail::crc32c(
+            {owner.expected.data() + part.offset, part.size},
+            checksum);
+    }
+
+    current.checksum = checksum;
+}
+
+void integrity_monitor::run(std::stop_token stop)
+{
+    // The checks must not compete with the application threads
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_LOWEST);
+
+    while (!stop.stop_requested())
+    {
+        {
+            std::unique_lock lock{mutex_};
+
+            // Only the stop request wakes the thread up early
+            wakeup_.wait_for(lock, stop, interval_, [] { return false; });
+        }
+
+        if (stop.stop_requested())
+            break;
+
+        check();
+    }
+}
+
+} // namespace cyanide
@@ -0,0 +1,116 @@
+#if !defined _WIN32
+    #error "Unsupported platform"
+#endif
+
+#include <cyanide/mapped_file.hpp>
+
+#include <Windows.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <utility> // std::exchange, std::move, std::swap
+
+namespace cyanide {
+
+namespace {
+    [[noreturn]] void throw_last_error(const char *function)
+    {
+        throw std::runtime_error{
+            std::string{"Failed to map the file - "} + function
+            + " failed with error code " + std::to_string(GetLastError())};
+    }
+} // namespace
+
+mapped_file::mapped_file(const std::filesystem::path &path)
+{
+    file_ = CreateFileW(
+        path.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr);
+
+    if (file_ == INVALID_HANDLE_VALUE)
+    {
+        file_ = nullptr;
+        throw_last_error("CreateFileW");
+    }
+
+    LARGE_INTEGER file_size{};
+
+    if (GetFileSizeEx(file_, &file_size) == 0)
+    {
+        CloseHandle(file_);
+        throw_last_error("GetFileSizeEx");
+    }
+
+    size_ = static_cast<std::size_t>(file_size.QuadPart);
+
+    // Empty files can't be mapped, but there's nothing to read anyway
+    if (size_ == 0)
+        return;
+
+    mapping_ =
+        CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+    if (mapping_ == nullptr)
+    {
+        CloseHandle(file_);
+        throw_last_error("CreateFileMappingW");
+    }
+
+    view_ = static_cast<const cyanide::byte_t *>(
+        MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+
+    if (view_ == nullptr)
+    {
+        CloseHandle(mapping_);
+        CloseHandle(file_);
+        throw_last_error("MapViewOfFile");
+    }
+}
+
+mapped_file::~mapped_file()
+{
+    if (view_)
+        UnmapViewOfFile(view_);
+
+    if (mapping_)
+        CloseHandle(mapping_);
+
+    if (file_)
+        CloseHandle(file_);
+}
+
+mapped_file::mapped_file(mapped_file &&other) noexcept
+    : file_{std::exchange(other.file_, nullptr)},
+      mapping_{std::exchange(other.mapping_, nullptr)},
+      view_{std::exchange(other.view_, nullptr)},
+      size_{std::exchange(other.size_, 0)}
+{}
+
+mapped_file &mapped_file::operator=(mapped_file &&other) noexcept
+{
+    mapped_file tmp{std::move(other)};
+
+    using std::swap;
+    swap(tmp, *this);
+
+    return *this;
+}
+
+void swap(mapped_file &lhs, mapped_file &rhs) noexcept
+{
+    using std::swap;
+
+    swap(lhs.file_, rhs.file_);
+    swap(lhs.mapping_, rhs.mapping_);
+    swap(lhs.view_, rhs.view_);
+    swap(lhs.size_, rhs.size_);
+}
+
+} // namespace cyanide
@@ -0,0 +1,52 @@
+#if !defined _WIN32
+    #error "Unsupported platform"
+#endif
+
+#include <cyanide/memory_snapshot.hpp>
+
+#include <Windows.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace cyanide {
+
+std::vector<std::uintptr_t>
+written_pages(const cyanide::memory_region &region, bool reset)
+{
+    SYSTEM_INFO system_info{};
+    GetSystemInfo(&system_info);
+
+    // Enough room for every page of the region, so a single call is enough
+    std::vector<PVOID> addresses(region.size / system_info.dwPageSize + 1);
+
+    ULONG_PTR count = addresses.size();
+    DWORD     granularity{};
+
+    if (GetWriteWatch(
+            reset ? WRITE_WATCH_FLAG_RESET : 0,
+            reinterpret_cast<PVOID>(region.base),
+            region.size,
+            addresses.data(),
+            &count,
+            &granularity)
+        != 0)
+    {
+        throw std::runtime_error{
+            "GetWriteWatch failed with error code "
+            + std::to_string(GetLastError())};
+    }
+
+    std::vector<std::uintptr_t> pages;
+    pages.reserve(count);
+
+    for (ULONG_PTR i = 0; i < count; ++i)
+        pages.push_back(reinterpret_cast<std::uintptr_t>(addresses[i]));
+
+    return pages;
+}
+
+} // namespace cyanide
@@ -0,0 +1,115 @@
+#include <cyanide/offset_table.hpp>
+
+#include <charconv> // std::from_chars
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <ios> // std::hex, std::showbase
+#include <istream> // std::getline
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error> // std::errc
+#include <utility> // std::move
+
+namespace cyanide {
+
+void offset_table::set(std::string name, std::uint64_t rva)
+{
+    // A line per entry on disk
+    if (name.find('\n') != std::string::npos)
+        throw std::invalid_argument{"Offset name must not contain newlines"};
+
+    offsets_.insert_or_assign(std::move(name), rva);
+}
+
+std::optional<std::uint64_t> offset_table::find(std::string_view name) const
+{
+    const auto it = offsets_.find(name);
+
+    if (it == offsets_.end())
+        return std::nullopt;
+
+    return it->second;
+}
+
+bool offset_table::resolve(
+    const cyanide::image_file &image,
+    std::string                name,
+    const cyanide::signature  &sig)
+{
+    const std::optional<std::uint64_t> rva = image.find_pattern(sig);
+
+    if (!rva)
+        return false;
+
+    set(std::move(name), *rva);
+
+    return true;
+}
+
+void offset_table::save(const std::filesystem::path &path) const
+{
+    std::ofstream file{path};
+
+    if (!file)
+        throw std::runtime_error{"Failed to open the offset table for writing"};
+
+    file << std::hex << std::showbase;
+
+    for (const auto &[name, rva] : offsets_)
+        file << name << ' ' << rva << '\n';
+}
+
+offset_table offset_table::load(const std::filesystem::path &path)
+{
+    std::ifstream file{path};
+
+    if (!file)
+        throw std::runtime_error{"Failed to open the offset table for reading"};
+
+    offset_table table;
+    std::string  line;
+
+    while (std::getline(file, line))
+    {
+        if (line.empty())
+            continue;
+
+        // The name may contain spaces (or be empty), the RVA can't
+        const std::size_t separator = line.rfind(' ');
+
+        if (separator == std::string::npos)
+            throw std::runtime_error{"Malformed offset table"};
+
+        // Written with std::showbase, which omits the prefix of zero
+        std::string_view rva_text = line;
+        rva_text.remove_prefix(separator + 1);
+
+        if (rva_text.starts_with("0x"))
+            rva_text.remove_prefix(2);
+
+        std::uint64_t rva = 0;
+
+        const auto [end, error] = std::from_chars(
+            rva_text.data(),
+            rva_text.data() + rva_text.size(),
+            rva,
+            16);
+
+        if (error != std::errc{} || end != rva_text.data() + rva_text.size())
+            throw std::runtime_error{"Malformed offset table"};
+
+        line.resize(separator);
+        table.set(std::move(line), rva);
+    }
+
+    if (!file.eof())
+        throw std::runtime_error{"Malformed offset table"};
+
+    return table;
+}
+
+} // namespace cyanide
@@ -0,0 +1,500 @@
+#include <cyanide/detail/crc32c.hpp>
+#include <cyanide/memory_protection.hpp>
+#include <cyanide/patch.hpp>
+#include <cyanide/patch_set.hpp>
+#include <cyanide/safe_pun.hpp>
+
+#include <algorithm> // std::equal, std::sort, std::unique
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility> // std::exchange, std::move, std::swap
+#include <vector>
+
+namespace cyanide {
+
+namespace {
+    constexpr std::size_t header_size        = 24;
+    constexpr std::size_t module_record_size = 8;
+    constexpr std::size_t entry_record_size  = 24;
+
+    constexpr std::uintptr_t page_size = 0x1000;
+
+    // Where the entry goes, the expected bytes are not checked if empty
+    struct patch_target {
+        std::uintptr_t                   address = 0;
+        std::span<const cyanide::byte_t> expected;
+        std::span<const cyanide::byte_t> replacement;
+    };
+
+    template <typename T>
+    void append(std::vector<cyanide::byte_t> &buffer, T value)
+    {
+        const auto *bytes = reinterpret_cast<const cyanide::byte_t *>(&value);
+        buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+    }
+
+    template <typename T>
+    T read_field(std::span<const cyanide::byte_t> record, std::size_t offset)
+    {
+        return cyanide::safe_pun<T>(record.data() + offset);
+    }
+
+    [[noreturn]] void throw_malformed()
+    {
+        throw std::runtime_error{"Malformed patch set"};
+    }
+
+    // Unprotect every page touched by the ranges, once per page
+    template <typename Range, typename Projection>
+    std::vector<cyanide::memory_protection>
+    unprotect_pages(const Range &ranges, Projection projection)
+    {
+        std::vector<std::uintptr_t> pages;
+
+        for (const auto &range : ranges)
+        {
+            const auto [address, size] = projection(range);
+
+            for (std::uintptr_t page = address & ~(page_size - 1);
+                 page < address + size;
+                 page += page_size)
+            {
+                // The entries are sorted, so most duplicates are adjacent
+                if (pages.empty() || pages.back() != page)
+                    pages.push_back(page);
+            }
+        }
+
+        std::sort(pages.begin(), pages.end());
+        pages.erase(std::unique(pages.begin(), pages.end()), pages.end());
+
+        std::vector<cyanide::memory_protection> protections;
+        protections.reserve(pages.size());
+
+        // Executable as well, the other threads may be running the code there
+        for (const std::uintptr_t page : pages)
+        {
+            protections.emplace_back(
+                reinterpret_cast<void *>(page),
+                page_size,
+                cyanide::protection_type::read_write_execute);
+        }
+
+        return protections;
+    }
+
+    std::vector<patch_target> make_targets(
+        const cyanide::patch_set        &set,
+        std::span<const std::uintptr_t> module_bases)
+    {
+        if (module_bases.size() < set.module_count())
+        {
+            throw std::invalid_argument{
+                "Expected " + std::to_string(set.module_count())
+                + " module bases, got " + std::to_string(module_bases.size())};
+        }
+
+        std::vector<patch_target> targets;
+        targets.reserve(set.size());
+
+        for (std::size_t i = 0; i < set.size(); ++i)
+        {
+            const cyanide::patch_set_entry entry = set[i];
+            const std::uintptr_t           base  = module_bases[entry.module];
+
+            if (base == 0)
+            {
+                throw std::invalid_argument{
+                    "Module \"" + std::string{set.module_name(entry.module)}
+                    + "\" is not loaded"};
+            }
+
+            targets.push_back(
+                {base + static_cast<std::uintptr_t>(entry.offset),
+                 entry.expected,
+                 entry.replacement});
+        }
+
+        return targets;
+    }
+
+    std::vector<cyanide::patch<>>
+    apply_targets(std::span<const patch_target> targets, bool unprotect)
+    {
+        // Check everything first, so that a mismatch leaves the memory intact
+        for (std::size_t i = 0; i < targets.size(); ++i)
+        {
+            const patch_target &target = targets[i];
+
+            if (!target.expected.empty()
+                && !std::equal(
+                    target.expected.begin(),
+                    target.expected.end(),
+                    reinterpret_cast<const cyanide::byte_t *>(target.address)))
+            {
+                throw std::runtime_error{
+                    "Patch set entry " + std::to_string(i)
+                    + " doesn't match the expected bytes"};
+            }
+        }
+
+        std::vector<cyanide::memory_protection> protections;
+
+        if (unprotect)
+        {
+            protections = unprotect_pages(
+                targets,
+                [](const patch_target &target) {
+                    return std::pair{
+                        target.address,
+                        target.replacement.size()};
+                });
+        }
+
+        // Destroyed before the protections if one of the patches throws
+        std::vector<cyanide::patch<>> patches;
+        patches.reserve(targets.size());
+
+        for (const patch_target &target : targets)
+        {
+            patches.emplace_back(
+                reinterpret_cast<void *>(target.address),
+                target.replacement,
+                false);
+        }
+
+        return patches;
+    }
+
+    void revert_patches(std::vector<cyanide::patch<>> &patches, bool unprotect)
+    {
+        std::vector<cyanide::memory_protection> protections;
+
+        if (unprotect)
+        {
+            protections = unprotect_pages(
+                patches,
+                [](const cyanide::patch<> &current) {
+                    return std::pair{
+                        reinterpret_cast<std::uintptr_t>(current.address()),
+                        current.size()};
+                });
+        }
+
+        // In the reverse order, as they were applied
+        while (!patches.empty())
+            patches.pop_back();
+    }
+} // namespace
+
+patch_set::patch_set(std::span<const cyanide::byte_t> data)
+{
+    if (data.size() < header_size || read_field<std::uint32_t>(data, 0) != magic
+        || read_field<std::uint32_t>(data, 4) != version)
+    {
+        throw std::runtime_error{"Unsupported patch set"};
+    }
+
+    module_count_ = read_field<std::uint32_t>(data, 8);
+    entry_count_  = read_field<std::uint32_t>(data, 12);
+
+    const auto data_size = read_field<std::uint32_t>(data, 16);
+    const auto checksum  = read_field<std::uint32_t>(data, 20);
+
+    // In 64 bits, the counts are arbitrary until validated
+    const std::uint64_t modules_size =
+        std::uint64_t{module_record_size} * module_count_;
+    const std::uint64_t entries_size =
+        std::uint64_t{entry_record_size} * entry_count_;
+
+    if (header_size + modules_size + entries_size + data_size != data.size())
+        throw_malformed();
+
+    const std::span<const cyanide::byte_t> body = data.subspan(header_size);
+
+    if (cyanide::detail::crc32c(body) != checksum)
+        throw std::runtime_error{"Patch set checksum mismatch"};
+
+    modules_ = body.first(static_cast<std::size_t>(modules_size));
+    entries_ = body.subspan(
+        modules_.size(),
+        static_cast<std::size_t>(entries_size));
+    data_ = body.subspan(modules_.size() + entries_.size());
+
+    for (std::size_t i = 0; i < module_count_; ++i)
+    {
+        const auto record = modules_.subspan(i * module_record_size);
+
+        if (std::uint64_t{read_field<std::uint32_t>(record, 0)}
+                + read_field<std::uint32_t>(record, 4)
+            > data_.size())
+        {
+            throw_malformed();
+        }
+    }
+
+    std::uint32_t previous_module = 0;
+    std::uint64_t previous_end    = 0;
+
+    for (std::size_t i = 0; i < entry_count_; ++i)
+    {
+        const auto record = entries_.subspan(i * entry_record_size);
+
+        const auto offset      = read_field<std::uint64_t>(record, 0);
+        const auto module      = read_field<std::uint32_t>(record, 8);
+        const auto size        = read_field<std::uint32_t>(record, 12);
+        const auto data_offset = read_field<std::uint32_t>(record, 16);
+
+        if (module >= module_count_ || size == 0
+            || std::uint64_t{data_offset} + 2 * std::uint64_t{size}
+                   > data_.size())
+        {
+            throw_malformed();
+        }
+
+        // Sorted and not overlapping, checked against the previous entry only
+        if (i != 0
+            && (module < previous_module
+                || (module == previous_module && offset < previous_end)))
+        {
+            throw_malformed();
+        }
+
+        if (offset + size < offset)
+            throw_malformed();
+
+        previous_module = module;
+        previous_end    = offset + size;
+    }
+}
+
+std::string_view patch_set::module_name(std::size_t index) const
+{
+    if (index >= module_count_)
+        throw std::out_of_range{"Module index is out of range"};
+
+    const auto record = modules_.subspan(index * module_record_size);
+
+    return {
+        reinterpret_cast<const char *>(data_.data())
+            + read_field<std::uint32_t>(record, 0),
+        read_field<std::uint32_t>(record, 4)};
+}
+
+cyanide::patch_set_entry patch_set::operator[](std::size_t index) const
+{
+    const auto record = entries_.subspan(index * entry_record_size);
+
+    const auto size        = read_field<std::uint32_t>(record, 12);
+    const auto data_offset = read_field<std::uint32_t>(record, 16);
+
+    return {
+        read_field<std::uint32_t>(record, 8),
+        read_field<std::uint64_t>(record, 0),
+        data_.subspan(data_offset, size),
+        data_.subspan(data_offset + size, size)};
+}
+
+void patch_set_builder::add(
+    std::string_view                 module,
+    std::uint64_t                    offset,
+    std::span<const cyanide::byte_t> expected,
+    std::span<const cyanide::byte_t> replacement)
+{
+    if (expected.empty() || expected.size() != replacement.size())
+    {
+        throw std::invalid_argument{
+            "Expected and replacement bytes must be of the same non-zero "
+            "size"};
+    }
+
+    std::uint32_t index = 0;
+
+    while (index < modules_.size() && modules_[index] != module)
+        ++index;
+
+    if (index == modules_.size())
+        modules_.emplace_back(module);
+
+    entries_.push_back(
+        {index,
+         offset,
+         {expected.begin(), expected.end()},
+         {replacement.begin(), replacement.end()}});
+}
+
+std::vector<cyanide::byte_t> patch_set_builder::build() const
+{
+    std::vector<const pending_entry *> sorted;
+    sorted.reserve(entries_.size());
+
+    for (const auto &entry : entries_)
+        sorted.push_back(&entry);
+
+    std::sort(
+        sorted.begin(),
+        sorted.end(),
+        [](const pending_entry *lhs, const pending_entry *rhs) {
+            return lhs->module != rhs->module ? lhs->module < rhs->module
+                                              : lhs->offset < rhs->offset;
+        });
+
+    for (std::size_t i = 1; i < sorted.size(); ++i)
+    {
+        const pending_entry &previous = *sorted[i - 1];
+
+        if (sorted[i]->module == previous.module
+            && sorted[i]->offset < previous.offset + previous.expected.size())
+        {
+            throw std::invalid_argument{
+                "Patches overlap at the offset "
+                + std::to_string(sorted[i]->offset) + " of \""
+                + modules_[previous.module] + "\""};
+        }
+    }
+
+    std::vector<cyanide::byte_t> data;
+
+    std::vector<cyanide::byte_t> body;
+
+    for (const auto &module : modules_)
+    {
+        append(body, static_cast<std::uint32_t>(data.size()));
+        append(body, static_cast<std::uint32_t>(module.size()));
+
+        data.insert(data.end(), module.begin(), module.end());
+    }
+
+    for (const pending_entry *entry : sorted)
+    {
+        append(body, entry->offset);
+        append(body, entry->module);
+        append(body, static_cast<std::uint32_t>(entry->expected.size()));
+        append(body, static_cast<std::uint32_t>(data.size()));
+        append(body, std::uint32_t{0});
+
+        data.insert(data.end(), entry->expected.begin(), entry->expected.end());
+        data.insert(
+            data.end(),
+            entry->replacement.begin(),
+            entry->replacement.end());
+    }
+
+    body.insert(body.end(), data.begin(), data.end());
+
+    std::vector<cyanide::byte_t> buffer;
+    buffer.reserve(header_size + body.size());
+
+    append(buffer, patch_set::magic);
+    append(buffer, patch_set::version);
+    append(buffer, static_cast<std::uint32_t>(modules_.size()));
+    append(buffer, static_cast<std::uint32_t>(sorted.size()));
+    append(buffer, static_cast<std::uint32_t>(data.size()));
+    append(buffer, cyanide::detail::crc32c(body));
+
+    buffer.insert(buffer.end(), body.begin(), body.end());
+
+    return buffer;
+}
+
+void patch_set_builder::save(const std::filesystem::path &path) const
+{
+    const std::vector<cyanide::byte_t> buffer = build();
+
+    std::ofstream file{path, std::ios::binary};
+
+    if (!file)
+        throw std::runtime_error{"Failed to open the patch set for writing"};
+
+    file.write(
+        reinterpret_cast<const char *>(buffer.data()),
+        static_cast<std::streamsize>(buffer.size()));
+}
+
+applied_patch_set::applied_patch_set(
+    const cyanide::patch_set        &set,
+    std::span<const std::uintptr_t> module_bases,
+    bool                             unprotect)
+    : patches_{apply_targets(make_targets(set, module_bases), unprotect)},
+      unprotect_{unprotect}
+{}
+
+applied_patch_set::~applied_patch_set()
+{
+    revert();
+}
+
+applied_patch_set::applied_patch_set(applied_patch_set &&other) noexcept
+    : patches_{std::move(other.patches_)},
+      unprotect_{std::exchange(other.unprotect_, true)}
+{}
+
+applied_patch_set &
+applied_patch_set::operator=(applied_patch_set &&other) noexcept
+{
+    applied_patch_set tmp{std::move(other)};
+
+    using std::swap;
+    swap(tmp, *this);
+
+    return *this;
+}
+
+void swap(applied_patch_set &lhs, applied_patch_set &rhs) noexcept
+{
+    using std::swap;
+
+    swap(lhs.patches_, rhs.patches_);
+    swap(lhs.unprotect_, rhs.unprotect_);
+}
+
+void applied_patch_set::replace(
+    const cyanide::patch_set        &set,
+    std::span<const std::uintptr_t> module_bases)
+{
+    const std::vector<patch_target> targets = make_targets(set, module_bases);
+
+    // The current contents, to put back if the new set doesn't apply
+    std::vector<std::vector<cyanide::byte_t>> current;
+    std::vector<patch_target>                 previous;
+
+    current.reserve(patches_.size());
+    previous.reserve(patches_.size());
+
+    for (const auto &applied : patches_)
+    {
+        const auto *bytes =
+            static_cast<const cyanide::byte_t *>(applied.address());
+
+        current.emplace_back(bytes, bytes + applied.size());
+        previous.push_back(
+            {reinterpret_cast<std::uintptr_t>(applied.address()),
+             {},
+             current.back()});
+    }
+
+    revert_patches(patches_, unprotect_);
+
+    try
+    {
+        patches_ = apply_targets(targets, unprotect_);
+    }
+    catch (...)
+    {
+        patches_ = apply_targets(previous, unprotect_);
+        throw;
+    }
+}
+
+void applied_patch_set::revert()
+{
+    revert_patches(patches_, unprotect_);
+}
+
+} // namespace cyanide
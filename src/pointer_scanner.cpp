@@ -0,0 +1,332 @@
+#include <cyanide/pointer_scanner.hpp>
+#include <cyanide/safe_pun.hpp>
+
+#include <algorithm> // std::sort, std::lower_bound, std::upper_bound, std::max
+#include <cstddef>
+#include <cstdint>
+#include <cstring> // std::memcpy
+#include <filesystem>
+#include <fstream>
+#include <iterator> // std::istreambuf_iterator, std::prev
+#include <limits>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread> // std::jthread, std::thread::hardware_concurrency
+#include <unordered_set>
+#include <utility> // std::move
+#include <vector>
+
+namespace cyanide {
+
+namespace {
+    constexpr std::uint32_t path_file_magic   = 0x50505943; // CYPP
+    constexpr std::uint32_t path_file_version = 1;
+
+    constexpr std::uint32_t no_parent = std::numeric_limits<std::uint32_t>::max();
+
+    // Node of the backwards search tree, the root is the target itself
+    struct search_node {
+        std::uintptr_t address = 0;
+        std::uint32_t  parent  = no_parent;
+        std::ptrdiff_t offset  = 0;
+    };
+
+    // Holder found by the worker, becomes a node or a path after merging
+    struct search_hit {
+        std::uintptr_t holder = 0;
+        std::uint32_t  parent = no_parent;
+        std::ptrdiff_t offset = 0;
+    };
+
+    template <typename T>
+    void append(std::vector<cyanide::byte_t> &buffer, T value)
+    {
+        const auto *bytes = reinterpret_cast<const cyanide::byte_t *>(&value);
+        buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+    }
+
+    template <typename T>
+    T consume(std::span<const cyanide::byte_t> &data)
+    {
+        if (data.size() < sizeof(T))
+            throw std::runtime_error{"Malformed pointer scan file"};
+
+        const T value = cyanide::safe_pun<T>(data.data());
+        data          = data.subspan(sizeof(T));
+
+        return value;
+    }
+} // namespace
+
+void pointer_scan_result::save(const std::filesystem::path &path) const
+{
+    std::vector<cyanide::byte_t> buffer;
+
+    append(buffer, path_file_magic);
+    append(buffer, path_file_version);
+    append(buffer, static_cast<std::uint32_t>(modules.size()));
+
+    for (const auto &module : modules)
+    {
+        append(buffer, static_cast<std::uint16_t>(module.size()));
+        buffer.insert(buffer.end(), module.begin(), module.end());
+    }
+
+    append(buffer, static_cast<std::uint32_t>(paths.size()));
+
+    for (const auto &pointer_path : paths)
+    {
+        append(buffer, static_cast<std::uint16_t>(pointer_path.module));
+        append(buffer, static_cast<std::uint8_t>(pointer_path.offsets.size()));
+        append(buffer, static_cast<std::uint32_t>(pointer_path.module_offset));
+
+        for (const std::ptrdiff_t offset : pointer_path.offsets)
+            append(buffer, static_cast<std::int32_t>(offset));
+    }
+
+    std::ofstream file{path, std::ios::binary};
+
+    if (!file)
+        throw std::runtime_error{"Failed to open the pointer scan file"};
+
+    file.write(
+        reinterpret_cast<const char *>(buffer.data()),
+        static_cast<std::streamsize>(buffer.size()));
+}
+
+pointer_scan_result
+pointer_scan_result::load(const std::filesystem::path &path)
+{
+    std::ifstream file{path, std::ios::binary};
+
+    if (!file)
+        throw std::runtime_error{"Failed to open the pointer scan file"};
+
+    const std::vector<cyanide::byte_t> buffer{
+        std::istreambuf_iterator<char>{file},
+        std::istreambuf_iterator<char>{}};
+
+    std::span<const cyanide::byte_t> data{buffer};
+
+    if (consume<std::uint32_t>(data) != path_file_magic
+        || consume<std::uint32_t>(data) != path_file_version)
+    {
+        throw std::runtime_error{"Unsupported pointer scan file"};
+    }
+
+    pointer_scan_result result;
+
+    result.modules.resize(consume<std::uint32_t>(data));
+
+    for (auto &module : result.modules)
+    {
+        const auto size = consume<std::uint16_t>(data);
+
+        if (data.size() < size)
+            throw std::runtime_error{"Malformed pointer scan file"};
+
+        module.assign(reinterpret_cast<const char *>(data.data()), size);
+        data = data.subspan(size);
+    }
+
+    result.paths.resize(consume<std::uint32_t>(data));
+
+    for (auto &pointer_path : result.paths)
+    {
+        pointer_path.module = consume<std::uint16_t>(data);
+        pointer_path.offsets.resize(consume<std::uint8_t>(data));
+        pointer_path.module_offset = consume<std::uint32_t>(data);
+
+        if (pointer_path.module >= result.modules.size())
+            throw std::runtime_error{"Malformed pointer scan file"};
+
+        for (auto &offset : pointer_path.offsets)
+            offset = consume<std::int32_t>(data);
+    }
+
+    return result;
+}
+
+void pointer_scanner::index_chunk(
+    std::uintptr_t                   base,
+    std::span<const cyanide::byte_t> data)
+{
+    constexpr std::size_t pointer_size = sizeof(std::uintptr_t);
+
+    // Only aligned pointers are considered, as compilers place them this way
+    for (std::size_t offset = 0; offset + pointer_size <= data.size();
+         offset += pointer_size)
+    {
+        const auto value =
+            cyanide::safe_pun<std::uintptr_t>(data.data() + offset);
+
+        if (value != 0 && is_readable(value))
+            index_.push_back({value, base + offset});
+    }
+}
+
+void pointer_scanner::finalize_index()
+{
+    std::sort(
+        index_.begin(),
+        index_.end(),
+        [](const index_entry &lhs, const index_entry &rhs) {
+            return lhs.value < rhs.value;
+        });
+
+    index_.shrink_to_fit();
+}
+
+bool pointer_scanner::is_readable(std::uintptr_t address) const noexcept
+{
+    const auto it = std::upper_bound(
+        regions_.begin(),
+        regions_.end(),
+        address,
+        [](std::uintptr_t value, const cyanide::memory_region &region) {
+            return value < region.base;
+        });
+
+    if (it == regions_.begin())
+        return false;
+
+    const auto &region = *std::prev(it);
+
+    return address - region.base < region.size;
+}
+
+std::optional<std::size_t>
+pointer_scanner::find_module(std::uintptr_t address) const noexcept
+{
+    const auto it = std::upper_bound(
+        modules_.begin(),
+        modules_.end(),
+        address,
+        [](std::uintptr_t value, const cyanide::module_info &module) {
+            return value < module.base;
+        });
+
+    if (it == modules_.begin())
+        return std::nullopt;
+
+    const auto &module = *std::prev(it);
+
+    if (address - module.base >= module.size)
+        return std::nullopt;
+
+    return static_cast<std::size_t>(std::prev(it) - modules_.begin());
+}
+
+pointer_scan_result
+pointer_scanner::find_paths(std::uintptr_t target, const options &opts) const
+{
+    pointer_scan_result result;
+
+    for (const auto &module : modules_)
+        result.modules.push_back(module.name);
+
+    const unsigned int threads_count =
+        opts.threads != 0
+            ? opts.threads
+            : std::max(1U, std::thread::hardware_concurrency());
+
+    std::vector<search_node> nodes{{target, no_parent, 0}};
+
+    std::unordered_set<std::uintptr_t> visited{target};
+
+    std::size_t level_begin = 0;
+
+    for (std::size_t depth = 0; depth < opts.max_depth; ++depth)
+    {
+        const std::size_t level_end  = nodes.size();
+        const std::size_t level_size = level_end - level_begin;
+
+        if (level_size == 0)
+            break;
+
+        const std::size_t workers_count =
+            std::min<std::size_t>(threads_count, level_size);
+
+        std::vector<std::vector<search_hit>> hits(workers_count);
+
+        {
+            std::vector<std::jthread> workers;
+            workers.reserve(workers_count);
+
+            for (std::size_t worker = 0; worker < workers_count; ++worker)
+            {
+                workers.emplace_back([&, worker] {
+                    // Every worker takes every workers_count-th node
+                    for (std::size_t i = level_begin + worker; i < level_end;
+                         i += workers_count)
+                    {
+                        const std::uintptr_t address = nodes[i].address;
+                        const std::uintptr_t lowest =
+                            address > opts.max_offset
+                                ? address - opts.max_offset
+                                : 0;
+
+                        auto it = std::lower_bound(
+                            index_.begin(),
+                            index_.end(),
+                            lowest,
+                            [](const index_entry &entry, std::uintptr_t value) {
+                                return entry.value < value;
+                            });
+
+                        for (; it != index_.end() && it->value <= address; ++it)
+                        {
+                            hits[worker].push_back(
+                                {it->holder,
+                                 static_cast<std::uint32_t>(i),
+                                 static_cast<std::ptrdiff_t>(
+                                     address - it->value)});
+                        }
+                    }
+                });
+            }
+        }
+
+        level_begin = level_end;
+
+        for (const auto &worker_hits : hits)
+        {
+            for (const search_hit &hit : worker_hits)
+            {
+                if (const auto module = find_module(hit.holder))
+                {
+                    pointer_path found{
+                        *module,
+                        hit.holder - modules_[*module].base,
+                        {hit.offset}};
+
+                    for (std::uint32_t node = hit.parent;
+                         nodes[node].parent != no_parent;
+                         node = nodes[node].parent)
+                    {
+                        found.offsets.push_back(nodes[node].offset);
+                    }
+
+                    result.paths.push_back(std::move(found));
+
+                    if (result.paths.size() >= opts.max_results)
+                        return result;
+                }
+
+                // Each address is expanded once, otherwise the search tree
+                // grows exponentially on cyclic structures
+                if (visited.insert(hit.holder).second)
+                    nodes.push_back({hit.holder, hit.parent, hit.offset});
+            }
+        }
+
+        if (nodes.size() > std::numeric_limits<std::uint32_t>::max())
+            break;
+    }
+
+    return result;
+}
+
+} // namespace cyanide
@@ -0,0 +1,249 @@
+#if !defined _WIN32
+    #error "Unsupported platform"
+#endif
+
+#include <cyanide/process_memory.hpp>
+
+#include <Windows.h>
+#include <TlHelp32.h>
+
+#include <algorithm> // std::sort
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility> // std::exchange, std::move, std::swap
+#include <vector>
+
+namespace cyanide {
+
+namespace {
+    bool is_readable(const MEMORY_BASIC_INFORMATION &info)
+    {
+        constexpr DWORD readable_mask = PAGE_READONLY | PAGE_READWRITE
+                                      | PAGE_WRITECOPY | PAGE_EXECUTE_READ
+                                      | PAGE_EXECUTE_READWRITE
+                                      | PAGE_EXECUTE_WRITECOPY;
+
+        return info.State == MEM_COMMIT && (info.Protect & PAGE_GUARD) == 0
+            && (info.Protect & readable_mask) != 0;
+    }
+
+    std::vector<cyanide::memory_region> query_readable_regions(HANDLE process)
+    {
+        std::vector<cyanide::memory_region> regions;
+
+        MEMORY_BASIC_INFORMATION info{};
+        std::uintptr_t           address = 0;
+
+        while (VirtualQueryEx(
+                   process,
+                   reinterpret_cast<LPCVOID>(address),
+                   &info,
+                   sizeof(info))
+               != 0)
+        {
+            const auto base = reinterpret_cast<std::uintptr_t>(info.BaseAddress);
+
+            if (is_readable(info))
+            {
+                // Merge adjacent regions to reduce the number of reads
+                if (!regions.empty()
+                    && regions.back().base + regions.back().size == base)
+                {
+                    regions.back().size += info.RegionSize;
+                }
+                else
+                {
+                    regions.push_back({base, info.RegionSize});
+                }
+            }
+
+            const std::uintptr_t next = base + info.RegionSize;
+
+            // Address space wrapped around
+            if (next <= address)
+                break;
+
+            address = next;
+        }
+
+        return regions;
+    }
+
+    /*
+     * Partial copy is reported as a failure, but bytes_read is still valid.
+     * Goes through the kernel even for the current process, so that the pages
+     * decommitted or protected after the regions were queried don't fault.
+     */
+    std::size_t read_memory(
+        HANDLE                     process,
+        std::uintptr_t             address,
+        std::span<cyanide::byte_t> buffer)
+    {
+        SIZE_T bytes_read = 0;
+
+        ReadProcessMemory(
+            process,
+            reinterpret_cast<LPCVOID>(address),
+            buffer.data(),
+            buffer.size(),
+            &bytes_read);
+
+        return bytes_read;
+    }
+
+    std::string to_utf8(const wchar_t *wide)
+    {
+        const int size = WideCharToMultiByte(
+            CP_UTF8,
+            0,
+            wide,
+            -1,
+            nullptr,
+            0,
+            nullptr,
+            nullptr);
+
+        if (size <= 1)
+            return {};
+
+        // The size includes the null terminator
+        std::string result(static_cast<std::size_t>(size - 1), '\0');
+
+        WideCharToMultiByte(
+            CP_UTF8,
+            0,
+            wide,
+            -1,
+            result.data(),
+            size,
+            nullptr,
+            nullptr);
+
+        return result;
+    }
+
+    std::vector<cyanide::module_info> query_modules(DWORD process_id)
+    {
+        HANDLE snapshot = CreateToolhelp32Snapshot(
+            TH32CS_SNAPMODULE | TH32CS_SNAPMODULE32,
+            process_id);
+
+        if (snapshot == INVALID_HANDLE_VALUE)
+        {
+            throw std::runtime_error{
+                "Failed to enumerate the modules - CreateToolhelp32Snapshot "
+                "failed with error code "
+                + std::to_string(GetLastError())};
+        }
+
+        std::vector<cyanide::module_info> modules;
+
+        MODULEENTRY32W entry{};
+        entry.dwSize = sizeof(entry);
+
+        for (BOOL found = Module32FirstW(snapshot, &entry); found != FALSE;
+             found      = Module32NextW(snapshot, &entry))
+        {
+            modules.push_back(
+                {to_utf8(entry.szModule),
+                 reinterpret_cast<std::uintptr_t>(entry.modBaseAddr),
+                 entry.modBaseSize});
+        }
+
+        CloseHandle(snapshot);
+
+        std::sort(
+            modules.begin(),
+            modules.end(),
+            [](const auto &lhs, const auto &rhs) { return lhs.base < rhs.base; });
+
+        return modules;
+    }
+} // namespace
+
+remote_process::remote_process(unsigned long process_id)
+    : process_id_{process_id}
+{
+    handle_ = OpenProcess(
+        PROCESS_VM_READ | PROCESS_QUERY_INFORMATION,
+        FALSE,
+        process_id);
+
+    if (handle_ == nullptr)
+    {
+        throw std::runtime_error{
+            "Failed to open the process - OpenProcess failed with error code "
+            + std::to_string(GetLastError())};
+    }
+}
+
+remote_process::~remote_process()
+{
+    // The object seems to be moved-from
+    if (!handle_)
+        return;
+
+    CloseHandle(handle_);
+}
+
+remote_process::remote_process(remote_process &&other) noexcept
+    : handle_{std::exchange(other.handle_, nullptr)},
+      process_id_{std::exchange(other.process_id_, 0)}
+{}
+
+remote_process &remote_process::operator=(remote_process &&other) noexcept
+{
+    remote_process tmp{std::move(other)};
+
+    using std::swap;
+    swap(tmp, *this);
+
+    return *this;
+}
+
+void swap(remote_process &lhs, remote_process &rhs) noexcept
+{
+    using std::swap;
+
+    swap(lhs.handle_, rhs.handle_);
+    swap(lhs.process_id_, rhs.process_id_);
+}
+
+std::size_t remote_process::read(
+    std::uintptr_t             address,
+    std::span<cyanide::byte_t> buffer) const
+{
+    return read_memory(handle_, address, buffer);
+}
+
+std::vector<cyanide::memory_region> remote_process::readable_regions() const
+{
+    return query_readable_regions(handle_);
+}
+
+std::vector<cyanide::module_info> remote_process::modules() const
+{
+    return query_modules(process_id_);
+}
+
+std::size_t local_process::read(
+    std::uintptr_t             address,
+    std::span<cyanide::byte_t> buffer) const
+{
+    return read_memory(GetCurrentProcess(), address, buffer);
+}
+
+std::vector<cyanide::memory_region> local_process::readable_regions() const
+{
+    return query_readable_regions(GetCurrentProcess());
+}
+
+std::vector<cyanide::module_info> local_process::modules() const
+{
+    return query_modules(GetCurrentProcessId());
+}
+
+} // namespace cyanide
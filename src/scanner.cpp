@@ -0,0 +1,104 @@
+#include <cyanide/detail/simd.hpp>
+#include <cyanide/scanner.hpp>
+
+#include <algorithm> // std::ranges::copy
+#include <bit>       // std::countr_zero
+#include <cstddef>
+#include <iterator> // std::back_inserter
+#include <span>
+#include <vector>
+
+namespace cyanide {
+
+const cyanide::byte_t *find_pattern(
+    std::span<const cyanide::byte_t> data,
+    const cyanide::signature        &sig) noexcept
+{
+    const std::size_t size = sig.size();
+
+    if (data.size() < size)
+        return nullptr;
+
+    // Pattern consisting of wildcards only matches anywhere
+    if (!sig.has_fixed_bytes())
+        return data.data();
+
+    const std::size_t     anchor      = sig.anchor();
+    const cyanide::byte_t anchor_byte = sig.bytes()[anchor];
+
+    // Position of the second anchor relative to the first one
+    const auto delta = static_cast<std::ptrdiff_t>(sig.second_anchor())
+                     - static_cast<std::ptrdiff_t>(anchor);
+    const cyanide::byte_t second_byte = sig.bytes()[sig.second_anchor()];
+
+    // Range of the positions the anchor may occupy, so that the whole pattern
+    // still fits into the data
+    const cyanide::byte_t *current = data.data() + anchor;
+    const cyanide::byte_t *last    = data.data() + (data.size() - size) + anchor;
+
+#if defined CYANIDE_SIMD_SSE2
+    const __m128i needle = _mm_set1_epi8(static_cast<char>(anchor_byte));
+    const __m128i second_needle =
+        _mm_set1_epi8(static_cast<char>(second_byte));
+
+    for (; last - current >= 15; current += 16)
+    {
+        // Both loads stay within the pattern bounds of the 16 positions
+        const __m128i block =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(current));
+        const __m128i second_block =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(current + delta));
+
+        auto hits = static_cast<unsigned int>(_mm_movemask_epi8(_mm_and_si128(
+            _mm_cmpeq_epi8(block, needle),
+            _mm_cmpeq_epi8(second_block, second_needle))));
+
+        while (hits != 0)
+        {
+            const cyanide::byte_t *candidate =
+                current + std::countr_zero(hits) - anchor;
+
+            if (sig.matches(candidate))
+                return candidate;
+
+            hits &= hits - 1;
+        }
+    }
+#endif
+
+    for (; current <= last; ++current)
+    {
+        if (*current == anchor_byte && current[delta] == second_byte
+            && sig.matches(current - anchor))
+        {
+            return current - anchor;
+        }
+    }
+
+    return nullptr;
+}
+
+std::vector<const cyanide::byte_t *> find_all_patterns(
+    std::span<const cyanide::byte_t> data,
+    const cyanide::signature        &sig)
+{
+    std::vector<const cyanide::byte_t *> matches;
+
+    std::ranges::copy(
+        cyanide::find_patterns(data, sig),
+        std::back_inserter(matches));
+
+    return matches;
+}
+
+#if defined __cpp_lib_generator
+std::generator<const cyanide::byte_t *> generate_patterns(
+    std::span<const cyanide::byte_t> data,
+    cyanide::signature               sig)
+{
+    for (const cyanide::byte_t *match : cyanide::find_patterns(data, sig))
+        co_yield match;
+}
+#endif
+
+} // namespace cyanide
@@ -0,0 +1,133 @@
+#include <cyanide/detail/byte_frequency.hpp>
+#include <cyanide/signature.hpp>
+
+#include <algorithm> // std::min
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace cyanide {
+
+namespace {
+    int hex_digit(char c)
+    {
+        if (c >= '0' && c <= '9')
+            return c - '0';
+
+        if (c >= 'a' && c <= 'f')
+            return c - 'a' + 10;
+
+        if (c >= 'A' && c <= 'F')
+            return c - 'A' + 10;
+
+        return -1;
+    }
+} // namespace
+
+signature::signature(std::string_view pattern)
+{
+    std::size_t pos = 0;
+
+    while (pos < pattern.size())
+    {
+        if (pattern[pos] == ' ')
+        {
+            ++pos;
+            continue;
+        }
+
+        const std::size_t token_end = std::min(
+            pattern.find(' ', pos),
+            pattern.size());
+        const std::string_view token = pattern.substr(pos, token_end - pos);
+
+        if (token == "?" || token == "??")
+        {
+            bytes_.push_back(0x00);
+            mask_.push_back(0x00);
+        }
+        else
+        {
+            const int high = token.size() == 2 ? hex_digit(token[0]) : -1;
+            const int low  = token.size() == 2 ? hex_digit(token[1]) : -1;
+
+            if (high < 0 || low < 0)
+            {
+                throw std::invalid_argument{
+                    "Invalid signature token: " + std::string{token}};
+            }
+
+            bytes_.push_back(static_cast<cyanide::byte_t>(high << 4 | low));
+            mask_.push_back(0xFF);
+        }
+
+        pos = token_end;
+    }
+
+    if (bytes_.empty())
+        throw std::invalid_argument{"Signature is empty"};
+
+    select_anchor();
+}
+
+signature::signature(
+    std::span<const cyanide::byte_t> bytes,
+    std::string_view                 mask)
+{
+    if (bytes.size() != mask.size())
+        throw std::invalid_argument{"Signature mask size mismatch"};
+
+    if (bytes.empty())
+        throw std::invalid_argument{"Signature is empty"};
+
+    bytes_.reserve(bytes.size());
+    mask_.reserve(mask.size());
+
+    for (std::size_t i = 0; i < bytes.size(); ++i)
+    {
+        const bool fixed = mask[i] != '?';
+
+        bytes_.push_back(fixed ? bytes[i] : 0x00);
+        mask_.push_back(fixed ? 0xFF : 0x00);
+    }
+
+    select_anchor();
+}
+
+void signature::select_anchor()
+{
+    const auto is_rarer = [this](std::size_t lhs, std::size_t rhs) {
+        return cyanide::detail::x86_byte_frequency[bytes_[lhs]]
+             < cyanide::detail::x86_byte_frequency[bytes_[rhs]];
+    };
+
+    std::optional<std::size_t> rarest;
+    std::optional<std::size_t> second_rarest;
+
+    for (std::size_t i = 0; i < mask_.size(); ++i)
+    {
+        if (mask_[i] == 0x00)
+            continue;
+
+        if (!rarest || is_rarer(i, *rarest))
+        {
+            second_rarest = rarest;
+            rarest        = i;
+        }
+        else if (!second_rarest || is_rarer(i, *second_rarest))
+        {
+            second_rarest = i;
+        }
+    }
+
+    if (!rarest)
+        return;
+
+    anchor_          = *rarest;
+    second_anchor_   = second_rarest.value_or(*rarest);
+    has_fixed_bytes_ = true;
+}
+
+} // namespace cyanide
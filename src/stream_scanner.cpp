@@ -0,0 +1,187 @@
+#include <cyanide/scanner.hpp>
+#include <cyanide/stream_scanner.hpp>
+
+#include <algorithm> // std::min
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception> // std::exception_ptr, std::current_exception
+#include <functional>
+#include <optional>
+#include <semaphore>
+#include <span>
+#include <stdexcept>
+#include <thread> // std::jthread
+#include <vector>
+
+namespace cyanide {
+
+stream_scanner::stream_scanner(
+    const cyanide::remote_process &process,
+    std::size_t                    window_size)
+    : process_{&process},
+      window_size_{window_size}
+{
+    if (window_size_ == 0)
+        throw std::invalid_argument{"Window size must not be zero"};
+
+    for (auto &buffer : buffers_)
+        buffer.resize(window_size_);
+}
+
+void stream_scanner::scan(
+    const cyanide::signature                  &sig,
+    const std::function<bool(std::uintptr_t)> &on_match)
+{
+    scan(sig, process_->readable_regions(), on_match);
+}
+
+void stream_scanner::scan(
+    const cyanide::signature                  &sig,
+    std::span<const cyanide::memory_region>    regions,
+    const std::function<bool(std::uintptr_t)> &on_match)
+{
+    const std::size_t pattern_size = sig.size();
+
+    if (pattern_size > window_size_)
+        throw std::invalid_argument{"Signature is longer than the window"};
+
+    // Consecutive windows overlap by pattern_size - 1 bytes
+    const std::size_t step = window_size_ - (pattern_size - 1);
+
+    struct window {
+        std::uintptr_t address = 0;
+        std::size_t    size    = 0;
+        bool           last    = false;
+    };
+
+    std::array<window, 2>                windows{};
+    std::array<std::binary_semaphore, 2> free_slots{
+        std::binary_semaphore{1},
+        std::binary_semaphore{1}};
+    std::array<std::binary_semaphore, 2> filled_slots{
+        std::binary_semaphore{0},
+        std::binary_semaphore{0}};
+
+    std::atomic<bool>  stop = false;
+    std::exception_ptr callback_exception;
+
+    std::jthread reader{[&] {
+        std::size_t slot = 0;
+
+        const auto read_regions = [&] {
+            for (const auto &region : regions)
+            {
+                if (region.size < pattern_size)
+                    continue;
+
+                for (std::size_t offset = 0;; offset += step)
+                {
+                    if (stop.load(std::memory_order_relaxed))
+                        return;
+
+                    const std::size_t size =
+                        std::min(window_size_, region.size - offset);
+
+                    free_slots[slot].acquire();
+
+                    windows[slot].address = region.base + offset;
+                    windows[slot].size    = process_->read(
+                        region.base + offset,
+                        std::span{buffers_[slot].data(), size});
+
+                    filled_slots[slot].release();
+                    slot ^= 1;
+
+                    if (offset + size == region.size)
+                        break;
+                }
+            }
+        };
+
+        read_regions();
+
+        // Tell the scanning side there are no more windows
+        free_slots[slot].acquire();
+        windows[slot].last = true;
+        filled_slots[slot].release();
+    }};
+
+    for (std::size_t slot = 0;; slot ^= 1)
+    {
+        filled_slots[slot].acquire();
+
+        const window current = windows[slot];
+
+        if (current.last)
+            break;
+
+        const std::span<const cyanide::byte_t> data{
+            buffers_[slot].data(),
+            current.size};
+
+        std::size_t offset = 0;
+
+        while (!stop.load(std::memory_order_relaxed))
+        {
+            const cyanide::byte_t *match =
+                cyanide::find_pattern(data.subspan(offset), sig);
+
+            if (!match)
+                break;
+
+            offset = static_cast<std::size_t>(match - data.data());
+
+            try
+            {
+                if (!on_match(current.address + offset))
+                    stop = true;
+            }
+            catch (...)
+            {
+                // Keep draining the windows, otherwise the reader thread
+                // will never finish
+                callback_exception = std::current_exception();
+                stop               = true;
+            }
+
+            ++offset;
+        }
+
+        free_slots[slot].release();
+    }
+
+    reader.join();
+
+    if (callback_exception)
+        std::rethrow_exception(callback_exception);
+}
+
+std::vector<std::uintptr_t>
+stream_scanner::scan_all(const cyanide::signature &sig)
+{
+    std::vector<std::uintptr_t> matches;
+
+    scan(sig, [&matches](std::uintptr_t address) {
+        matches.push_back(address);
+        return true;
+    });
+
+    return matches;
+}
+
+std::optional<std::uintptr_t>
+stream_scanner::scan_first(const cyanide::signature &sig)
+{
+    std::optional<std::uintptr_t> match;
+
+    scan(sig, [&match](std::uintptr_t address) {
+        match = address;
+        return false;
+    });
+
+    return match;
+}
+
+} // namespace cyanide
@@ -0,0 +1,112 @@
+#if !defined _WIN32
+    #error "Unsupported platform"
+#endif
+
+#include <cyanide/detail/thread_state.hpp>
+
+#include <Windows.h>
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility> // std::move
+#include <vector>
+
+namespace cyanide::detail {
+
+namespace {
+    using block_t = std::array<hook_thread_state, thread_state::max_hooks>;
+
+    std::mutex                                slots_mutex;
+    std::array<bool, thread_state::max_hooks> taken_slots{};
+
+    // Blocks of all the live threads, the released slot is reset in each
+    std::vector<block_t *> live_blocks;
+
+    // Frees the block of the thread on its exit
+    struct block_owner {
+        std::unique_ptr<block_t> block;
+
+        ~block_owner()
+        {
+            if (!block)
+                return;
+
+            TlsSetValue(thread_state::tls_index(), nullptr);
+
+            std::lock_guard lock{slots_mutex};
+            std::erase(live_blocks, block.get());
+        }
+    };
+
+    thread_local block_owner current_block;
+} // namespace
+
+unsigned long thread_state::tls_index()
+{
+    static const DWORD index = [] {
+        const DWORD allocated = TlsAlloc();
+
+        if (allocated == TLS_OUT_OF_INDEXES)
+        {
+            throw std::runtime_error{
+                "TlsAlloc failed with error code "
+                + std::to_string(GetLastError())};
+        }
+
+        return allocated;
+    }();
+
+    return index;
+}
+
+hook_thread_state *thread_state::current()
+{
+    if (!current_block.block)
+    {
+        auto block = std::make_unique<block_t>();
+
+        {
+            std::lock_guard lock{slots_mutex};
+            live_blocks.push_back(block.get());
+        }
+
+        current_block.block = std::move(block);
+        TlsSetValue(tls_index(), current_block.block->data());
+    }
+
+    return current_block.block->data();
+}
+
+std::size_t thread_state::acquire_slot()
+{
+    std::lock_guard lock{slots_mutex};
+
+    for (std::size_t slot = 0; slot < taken_slots.size(); ++slot)
+    {
+        if (!taken_slots[slot])
+        {
+            taken_slots[slot] = true;
+            return slot;
+        }
+    }
+
+    throw std::runtime_error{"No free hook slots left"};
+}
+
+void thread_state::release_slot(std::size_t slot) noexcept
+{
+    std::lock_guard lock{slots_mutex};
+
+    // The next hook given the slot must start from the clean state on every
+    // thread, e.g. with the first call sampled
+    for (block_t *block : live_blocks)
+        (*block)[slot] = hook_thread_state{};
+
+    taken_slots[slot] = false;
+}
+
+} // namespace cyanide::detail
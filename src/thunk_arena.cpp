@@ -0,0 +1,81 @@
+#if !defined _WIN32
+    #error "Unsupported platform"
+#endif
+
+#include <cyanide/detail/thunk_template.hpp>
+
+#include <Windows.h>
+
+#include <cstddef>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace cyanide::detail {
+
+namespace {
+    constexpr std::size_t chunk_size = 0x10000;
+
+    std::mutex                     arena_mutex;
+    std::vector<cyanide::byte_t *> free_slots;
+    cyanide::byte_t               *chunk_cursor = nullptr;
+    cyanide::byte_t               *chunk_end    = nullptr;
+    std::size_t                    slot_count   = 0;
+} // namespace
+
+cyanide::byte_t *thunk_arena::allocate()
+{
+    std::lock_guard lock{arena_mutex};
+
+    if (!free_slots.empty())
+    {
+        cyanide::byte_t *slot = free_slots.back();
+        free_slots.pop_back();
+
+        return slot;
+    }
+
+    if (chunk_cursor == chunk_end)
+    {
+        // So that the release never has to grow the vector
+        free_slots.reserve(slot_count + chunk_size / slot_size);
+
+        void *chunk = VirtualAlloc(
+            nullptr,
+            chunk_size,
+            MEM_COMMIT | MEM_RESERVE,
+            PAGE_EXECUTE_READWRITE);
+
+        if (!chunk)
+        {
+            throw std::runtime_error{
+                "VirtualAlloc failed with error code "
+                + std::to_string(GetLastError())};
+        }
+
+        chunk_cursor = static_cast<cyanide::byte_t *>(chunk);
+        chunk_end    = chunk_cursor + chunk_size;
+        slot_count += chunk_size / slot_size;
+    }
+
+    cyanide::byte_t *slot = chunk_cursor;
+    chunk_cursor += slot_size;
+
+    return slot;
+}
+
+void thunk_arena::commit(const cyanide::byte_t *slot) noexcept
+{
+    FlushInstructionCache(GetCurrentProcess(), slot, slot_size);
+}
+
+void thunk_arena::release(const cyanide::byte_t *slot) noexcept
+{
+    std::lock_guard lock{arena_mutex};
+
+    // Never reallocates, the space is reserved along with the chunks
+    free_slots.push_back(const_cast<cyanide::byte_t *>(slot));
+}
+
+} // namespace cyanide::detail
@@ -0,0 +1,10 @@
+// Module loaded at runtime by the deferred hooks tests
+
+extern "C" __declspec(dllexport) __declspec(noinline) int __cdecl
+plugin_function(int x)
+{
+    if (x == 0)
+        return 0;
+
+    return x * 3 - 1;
+}
@@ -0,0 +1,87 @@
+#define NOMINMAX
+
+#include <cyanide/deferred_hooks.hpp>
+#include <cyanide/hook_impl_polyhook.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <Windows.h> // LoadLibraryW, GetProcAddress, FreeLibrary
+
+#include <cstdint>
+
+namespace {
+using plugin_function_t = int(__cdecl *)(int);
+
+constexpr const char    *plugin_name      = "cyanide_test_plugin.dll";
+constexpr const wchar_t *plugin_name_wide = L"cyanide_test_plugin.dll";
+
+std::uintptr_t plugin_function_offset()
+{
+    const HMODULE plugin = LoadLibraryW(plugin_name_wide);
+    REQUIRE(plugin != nullptr);
+
+    const auto function = reinterpret_cast<std::uintptr_t>(
+        GetProcAddress(plugin, "plugin_function"));
+    const auto offset = function - reinterpret_cast<std::uintptr_t>(plugin);
+
+    FreeLibrary(plugin);
+
+    return offset;
+}
+} // namespace
+
+TEST_CASE("Installing the hook on module load", "[deferred_hooks]")
+{
+    const std::uintptr_t offset = plugin_function_offset();
+
+    cyanide::deferred_hooks hooks;
+
+    hooks.add<cyanide::polyhook_x86, plugin_function_t>(
+        plugin_name,
+        offset,
+        [](plugin_function_t orig, int x) { return orig(x) + 100; });
+
+    // Not loaded yet
+    REQUIRE(hooks.installed_count() == 0);
+
+    const HMODULE plugin = LoadLibraryW(plugin_name_wide);
+    REQUIRE(plugin != nullptr);
+    REQUIRE(hooks.installed_count() == 1);
+
+    const auto function = reinterpret_cast<plugin_function_t>(
+        GetProcAddress(plugin, "plugin_function"));
+    REQUIRE(function(2) == 105);
+
+    FreeLibrary(plugin);
+    REQUIRE(hooks.installed_count() == 0);
+}
+
+TEST_CASE("Installing the hook into the loaded module", "[deferred_hooks]")
+{
+    const std::uintptr_t offset = plugin_function_offset();
+
+    const HMODULE plugin = LoadLibraryW(plugin_name_wide);
+    REQUIRE(plugin != nullptr);
+
+    {
+        cyanide::deferred_hooks hooks;
+
+        hooks.add<cyanide::polyhook_x86, plugin_function_t>(
+            plugin_name,
+            offset,
+            [](plugin_function_t orig, int x) { return orig(x) * 2; });
+
+        REQUIRE(hooks.installed_count() == 1);
+
+        const auto function = reinterpret_cast<plugin_function_t>(
+            GetProcAddress(plugin, "plugin_function"));
+        REQUIRE(function(2) == 10);
+    }
+
+    // Uninstalled together with the registry
+    const auto function = reinterpret_cast<plugin_function_t>(
+        GetProcAddress(plugin, "plugin_function"));
+    REQUIRE(function(2) == 5);
+
+    FreeLibrary(plugin);
+}
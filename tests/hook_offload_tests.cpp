@@ -0,0 +1,229 @@
+#define NOMINMAX
+
+#include <cyanide/detail/bounded_queue.hpp>
+#include <cyanide/hook_impl_polyhook.hpp>
+#include <cyanide/hook_offload.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm> // std::sort
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <thread> // std::jthread, std::this_thread
+#include <utility> // std::pair
+#include <vector>
+
+__declspec(noinline) int __cdecl offloaded_func(int x, const double &y)
+{
+    return x + static_cast<int>(y);
+}
+
+namespace {
+int __cdecl plain_func(int x)
+{
+    return x * 2;
+}
+} // namespace
+
+TEST_CASE("Queue of multiple producers", "[hook_offload]")
+{
+    cyanide::detail::bounded_queue<int> queue{3};
+    REQUIRE(queue.capacity() == 4);
+
+    for (int i = 0; i < 4; ++i)
+        REQUIRE(queue.try_push(i));
+
+    REQUIRE_FALSE(queue.try_push(4));
+    REQUIRE(queue.size() == 4);
+
+    int value = 0;
+    REQUIRE(queue.try_pop(value));
+    REQUIRE(value == 0);
+
+    // Wraps around
+    REQUIRE(queue.try_push(5));
+
+    for (const int expected : {1, 2, 3, 5})
+    {
+        REQUIRE(queue.try_pop(value));
+        REQUIRE(value == expected);
+    }
+
+    REQUIRE_FALSE(queue.try_pop(value));
+
+    constexpr int per_thread = 10000;
+
+    cyanide::detail::bounded_queue<int> shared{64};
+    std::atomic<std::int64_t>           sum = 0;
+
+    {
+        std::vector<std::jthread> threads;
+
+        for (int producer = 0; producer < 4; ++producer)
+        {
+            threads.emplace_back([&shared] {
+                for (int i = 1; i <= per_thread; ++i)
+                {
+                    while (!shared.try_push(i))
+                        std::this_thread::yield();
+                }
+            });
+        }
+
+        for (int consumer = 0; consumer < 2; ++consumer)
+        {
+            threads.emplace_back([&shared, &sum] {
+                int popped = 0;
+
+                for (int received = 0; received < 2 * per_thread;)
+                {
+                    if (shared.try_pop(popped))
+                    {
+                        sum += popped;
+                        ++received;
+                    }
+                }
+            });
+        }
+    }
+
+    REQUIRE(sum == 4 * std::int64_t{per_thread} * (per_thread + 1) / 2);
+}
+
+TEST_CASE("Offloading the hooked calls", "[hook_offload]")
+{
+    std::mutex                          mutex;
+    std::vector<std::pair<int, double>> observed;
+
+    {
+        cyanide::hook_offload offload{2};
+
+        cyanide::polyhook_x86 hook{
+            &offloaded_func,
+            offload.observe<decltype(&offloaded_func)>(
+                [&](int x, double y) {
+                    std::lock_guard lock{mutex};
+                    observed.emplace_back(x, y);
+                })};
+
+        hook.install();
+
+        // The original function runs as usual
+        REQUIRE(offloaded_func(1, 2.0) == 3);
+        REQUIRE(offloaded_func(4, 0.5) == 4);
+
+        offload.wait();
+
+        std::lock_guard lock{mutex};
+        REQUIRE(observed.size() == 2);
+    }
+
+    std::sort(observed.begin(), observed.end());
+
+    REQUIRE(observed[0] == std::pair{1, 2.0});
+    REQUIRE(observed[1] == std::pair{4, 0.5});
+}
+
+TEST_CASE("Offloading under backpressure", "[hook_offload]")
+{
+    std::atomic<bool> released = false;
+    std::atomic<int>  calls    = 0;
+
+    const auto callback = [&](int) {
+        // Keeps the worker busy, so that the queue fills up
+        while (!released)
+            std::this_thread::yield();
+
+        ++calls;
+    };
+
+    SECTION("Dropping")
+    {
+        cyanide::hook_offload offload{1, 4, cyanide::offload_policy::drop};
+
+        auto observer = offload.observe<decltype(&plain_func)>(callback);
+
+        // One is taken by the worker, four wait in the queue
+        for (int i = 0; i < 20; ++i)
+            REQUIRE(observer(&plain_func, i) == i * 2);
+
+        REQUIRE(offload.dropped() >= 15);
+
+        released = true;
+        offload.wait();
+
+        REQUIRE(calls + offload.dropped() == 20);
+    }
+
+    SECTION("Blocking")
+    {
+        cyanide::hook_offload offload{1, 4, cyanide::offload_policy::block};
+
+        auto observer = offload.observe<decltype(&plain_func)>(callback);
+
+        std::jthread releaser{[&released] {
+            std::this_thread::sleep_for(std::chrono::milliseconds{20});
+            released = true;
+        }};
+
+        for (int i = 0; i < 20; ++i)
+            observer(&plain_func, i);
+
+        offload.wait();
+
+        REQUIRE(calls == 20);
+        REQUIRE(offload.dropped() == 0);
+    }
+
+    SECTION("Sampling")
+    {
+        cyanide::hook_offload offload{
+            1,
+            64,
+            cyanide::offload_policy::sample,
+            4};
+
+        auto observer = offload.observe<decltype(&plain_func)>(callback);
+
+        // 32 fill the half of the queue, then every 4th of the rest goes in
+        for (int i = 0; i < 97; ++i)
+            observer(&plain_func, i);
+
+        released = true;
+        offload.wait();
+
+        REQUIRE(offload.dropped() >= 48);
+        REQUIRE(calls + offload.dropped() == 97);
+    }
+
+    SECTION("Sampling in multiple pools")
+    {
+        cyanide::hook_offload first{1, 64, cyanide::offload_policy::sample, 2};
+        cyanide::hook_offload second{
+            1,
+            64,
+            cyanide::offload_policy::sample,
+            2};
+
+        auto first_observer  = first.observe<decltype(&plain_func)>(callback);
+        auto second_observer = second.observe<decltype(&plain_func)>(callback);
+
+        // The pools count their calls apart, each offloads every 2nd of the
+        // calls past the half of its queue
+        for (int i = 0; i < 65; ++i)
+        {
+            first_observer(&plain_func, i);
+            second_observer(&plain_func, i);
+        }
+
+        released = true;
+        first.wait();
+        second.wait();
+
+        REQUIRE(first.dropped() <= 17);
+        REQUIRE(second.dropped() <= 17);
+        REQUIRE(calls + first.dropped() + second.dropped() == 130);
+    }
+}
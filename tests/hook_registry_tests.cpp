@@ -0,0 +1,249 @@
+#define NOMINMAX
+
+#include <cyanide/hook_impl_polyhook.hpp>
+#include <cyanide/hook_registry.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cstdint>
+#include <memory> // std::make_shared
+#include <stdexcept>
+#include <vector>
+
+__declspec(noinline) int registry_test_func(int x)
+{
+    if (x == 0)
+        return 0;
+
+    x *= 3;
+
+    return x / 2 + 1;
+}
+
+namespace {
+// Records the calls instead of hooking anything
+struct fake_hook {
+    void *target      = nullptr;
+    int   installs    = 0;
+    int   uninstalls  = 0;
+    bool  fail_install = false;
+
+    void install()
+    {
+        if (fail_install)
+            throw std::runtime_error{"Install failed"};
+
+        ++installs;
+    }
+
+    void uninstall()
+    {
+        ++uninstalls;
+    }
+
+    [[nodiscard]] void *source() const
+    {
+        return target;
+    }
+};
+} // namespace
+
+TEST_CASE("Registering the hooks and patches", "[hook_registry]")
+{
+    // Single-byte instructions, so each hook covers just the detour
+    std::array<cyanide::byte_t, 64> code{};
+    code.fill(0x90);
+
+    cyanide::hook_registry registry;
+
+    auto first  = std::make_shared<fake_hook>(fake_hook{&code[0]});
+    auto second = std::make_shared<fake_hook>(fake_hook{&code[32]});
+
+    const auto second_id = registry.add_hook("second", second);
+    const auto first_id  = registry.add_hook("first", first);
+
+    const std::array<cyanide::byte_t, 2> bytes{0xCC, 0xCC};
+    const auto patch_id = registry.add_patch("patch", &code[16], bytes);
+
+    REQUIRE(code[16] == 0xCC);
+    REQUIRE(registry.size() == 3);
+
+    SECTION("Lookups")
+    {
+        const auto found = registry.find(&code[4]);
+        REQUIRE(found);
+        REQUIRE(found->id == first_id);
+        REQUIRE(found->name == "first");
+        REQUIRE(found->kind == cyanide::registry_entry_kind::hook);
+        REQUIRE_FALSE(found->installed);
+
+        REQUIRE_FALSE(registry.find(&code[5]));
+        REQUIRE(registry.find(&code[17])->id == patch_id);
+        REQUIRE_FALSE(registry.find(&code[18]));
+
+        REQUIRE(registry.get(second_id)->name == "second");
+
+        const auto entries = registry.entries();
+        REQUIRE(entries.size() == 3);
+        REQUIRE(entries[0].id == first_id);
+        REQUIRE(entries[1].id == patch_id);
+        REQUIRE(entries[2].id == second_id);
+    }
+
+    SECTION("Conflicts")
+    {
+        const std::array<cyanide::byte_t, 4> overlapping{1, 2, 3, 4};
+
+        // Tail of the first hook
+        REQUIRE_THROWS_AS(
+            registry.add_patch("overlapping", &code[2], overlapping),
+            std::invalid_argument);
+
+        // Reaches the patch
+        REQUIRE_THROWS_AS(
+            registry.add_hook(
+                "overlapping",
+                std::make_shared<fake_hook>(fake_hook{&code[12]})),
+            std::invalid_argument);
+
+        // Nothing has been written
+        REQUIRE(code[2] == 0x90);
+        REQUIRE(registry.size() == 3);
+
+        // Adjacent ranges are fine
+        REQUIRE_NOTHROW(registry.add_patch("adjacent", &code[5], overlapping));
+    }
+
+    SECTION("Bulk operations")
+    {
+        REQUIRE(registry.install_all() == 2);
+        REQUIRE(registry.install_all() == 0);
+        REQUIRE(first->installs == 1);
+        REQUIRE(registry.find(&code[32])->installed);
+
+        REQUIRE(registry.uninstall_all() == 2);
+        REQUIRE(second->uninstalls == 1);
+
+        // Patches stay applied
+        REQUIRE(code[16] == 0xCC);
+    }
+
+    SECTION("Rolling back the failed bulk install")
+    {
+        second->fail_install = true;
+
+        REQUIRE_THROWS_AS(registry.install_all(), std::runtime_error);
+
+        REQUIRE(first->installs == 1);
+        REQUIRE(first->uninstalls == 1);
+        REQUIRE_FALSE(registry.get(first_id)->installed);
+    }
+
+    SECTION("Removal")
+    {
+        registry.install(first_id);
+
+        registry.remove(first_id);
+        REQUIRE(first->uninstalls == 1);
+        REQUIRE_FALSE(registry.get(first_id));
+        REQUIRE_FALSE(registry.find(&code[0]));
+
+        registry.remove(patch_id);
+        REQUIRE(code[16] == 0x90);
+
+        // The moved entry is still reachable
+        REQUIRE(registry.find(&code[32])->id == second_id);
+        REQUIRE(registry.size() == 1);
+    }
+}
+
+TEST_CASE("Registering many hooks", "[hook_registry]")
+{
+    constexpr std::size_t count = 10000;
+
+    std::vector<cyanide::byte_t> code(count * 8, 0x90);
+
+    cyanide::hook_registry registry;
+
+    // Descending, so that every insertion goes to the front of the index
+    for (std::size_t i = count; i-- > 0;)
+    {
+        registry.add_hook(
+            "hook",
+            std::make_shared<fake_hook>(fake_hook{&code[i * 8]}));
+    }
+
+    REQUIRE(registry.install_all() == count);
+
+    for (std::size_t i = 0; i < count; i += 997)
+    {
+        REQUIRE(registry.find(&code[i * 8 + 4]));
+        REQUIRE_FALSE(registry.find(&code[i * 8 + 5]));
+    }
+
+    REQUIRE(registry.uninstall_all() == count);
+}
+
+TEST_CASE("Sizing the hook range by the instructions", "[hook_registry]")
+{
+    // push ebp; mov ebp, esp; sub esp, 10h; ret
+    std::array<cyanide::byte_t, 8> code{
+        0x55, 0x8B, 0xEC, 0x83, 0xEC, 0x10, 0xC3, 0xCC};
+
+    cyanide::hook_registry registry;
+
+    const auto id = registry.add_hook(
+        "prologue",
+        std::make_shared<fake_hook>(fake_hook{code.data()}));
+
+    // The detour ends in the middle of sub esp, 10h
+    REQUIRE(registry.get(id)->size == 6);
+    REQUIRE(registry.find(&code[5])->id == id);
+    REQUIRE_FALSE(registry.find(&code[6]));
+
+    const std::array<cyanide::byte_t, 1> bytes{0x20};
+
+    REQUIRE_THROWS_AS(
+        registry.add_patch("immediate", &code[5], bytes),
+        std::invalid_argument);
+    REQUIRE(code[5] == 0x10);
+
+    REQUIRE_NOTHROW(registry.add_patch("ret", &code[6], bytes));
+}
+
+TEST_CASE("Registering the detours", "[hook_registry]")
+{
+    constexpr int x                      = 4;
+    constexpr int expected_result        = 7;
+    constexpr int expected_result_hooked = 12;
+
+    {
+        cyanide::hook_registry registry;
+
+        const auto id = registry.emplace<cyanide::polyhook_x86>(
+            "detour",
+            &registry_test_func,
+            [](decltype(&registry_test_func) orig, int x) {
+                return orig(x) + 5;
+            });
+
+        REQUIRE(registry.install_all() == 1);
+        REQUIRE(registry_test_func(x) == expected_result_hooked);
+
+        REQUIRE(registry.uninstall_all() == 1);
+        REQUIRE(registry_test_func(x) == expected_result);
+
+        // Destroys the uninstalled hook
+        registry.remove(id);
+        REQUIRE(registry.size() == 0);
+
+        // Never installed, destroyed along with the registry
+        registry.emplace<cyanide::polyhook_x86>(
+            "idle",
+            &registry_test_func,
+            [](int x) { return x; });
+    }
+
+    REQUIRE(registry_test_func(x) == expected_result);
+}
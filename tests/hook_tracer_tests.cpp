@@ -0,0 +1,144 @@
+#define NOMINMAX
+
+#include <cyanide/detail/spsc_ring.hpp>
+#include <cyanide/hook_impl_polyhook.hpp>
+#include <cyanide/hook_tracer.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstring> // std::memcpy
+#include <filesystem>
+#include <fstream>
+#include <iterator> // std::istreambuf_iterator
+#include <vector>
+
+__declspec(noinline) int __cdecl traced_func(int x, short y)
+{
+    return x + y;
+}
+
+namespace {
+std::vector<char> read_file(const std::filesystem::path &path)
+{
+    std::ifstream file{path, std::ios::binary};
+
+    return {std::istreambuf_iterator<char>{file}, {}};
+}
+} // namespace
+
+TEST_CASE("Ring of a single producer", "[hook_tracer]")
+{
+    cyanide::detail::spsc_ring<int> ring{3};
+    REQUIRE(ring.capacity() == 4);
+
+    for (int i = 0; i < 4; ++i)
+        REQUIRE(ring.try_push(i));
+
+    REQUIRE_FALSE(ring.try_push(4));
+
+    std::vector<int> drained;
+    REQUIRE(ring.drain(drained) == 4);
+    REQUIRE(drained == std::vector{0, 1, 2, 3});
+
+    // Wraps around
+    REQUIRE(ring.try_push(5));
+    REQUIRE(ring.drain(drained) == 1);
+    REQUIRE(drained.back() == 5);
+}
+
+TEST_CASE("Tracing the hooked calls", "[hook_tracer]")
+{
+    const auto path =
+        std::filesystem::temp_directory_path() / "cyanide_tracer_test.trace";
+
+    {
+        // Written by the explicit flush only
+        cyanide::hook_tracer tracer{path, 16, std::chrono::hours{1}};
+
+        int callback_calls = 0;
+
+        cyanide::polyhook_x86 hook{
+            &traced_func,
+            tracer.trace<decltype(&traced_func)>(
+                7,
+                [&callback_calls](decltype(&traced_func) orig, int x, short y) {
+                    ++callback_calls;
+                    return orig(x, y) * 2;
+                })};
+
+        hook.install();
+
+        REQUIRE(traced_func(1, 2) == 6);
+        REQUIRE(traced_func(-3, 4) == 2);
+        REQUIRE(callback_calls == 2);
+
+        REQUIRE(tracer.flush() == 2);
+        REQUIRE(tracer.flush() == 0);
+
+        // The rest don't fit into the ring
+        for (int i = 0; i < 20; ++i)
+            traced_func(i, 0);
+
+        REQUIRE(tracer.dropped() == 4);
+    }
+
+    const std::vector<char> contents = read_file(path);
+    REQUIRE(contents.size() == 12 + 18 * sizeof(cyanide::trace_event));
+
+    std::uint32_t header[3];
+    std::memcpy(header, contents.data(), sizeof(header));
+
+    REQUIRE(header[0] == cyanide::hook_tracer::magic);
+    REQUIRE(header[1] == cyanide::hook_tracer::version);
+    REQUIRE(header[2] == sizeof(cyanide::trace_event));
+
+    cyanide::trace_event first;
+    cyanide::trace_event second;
+    std::memcpy(&first, contents.data() + 12, sizeof(first));
+    std::memcpy(&second, contents.data() + 12 + sizeof(first), sizeof(second));
+
+    REQUIRE(first.hook_id == 7);
+    REQUIRE(first.arg_count == 2);
+    REQUIRE(first.args[0] == 1);
+    REQUIRE(first.args[1] == 2);
+    REQUIRE(first.return_address != 0);
+
+    REQUIRE(static_cast<int>(second.args[0]) == -3);
+    REQUIRE(second.timestamp >= first.timestamp);
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Alternating between the tracers", "[hook_tracer]")
+{
+    const auto directory = std::filesystem::temp_directory_path();
+
+    {
+        cyanide::hook_tracer first{
+            directory / "cyanide_tracer_first.trace",
+            16,
+            std::chrono::hours{1}};
+        cyanide::hook_tracer second{
+            directory / "cyanide_tracer_second.trace",
+            16,
+            std::chrono::hours{1}};
+
+        for (int i = 0; i < 20; ++i)
+        {
+            first.record({});
+            second.record({});
+        }
+
+        // A ring per thread and tracer, kept between the switches
+        REQUIRE(first.ring_count() + second.ring_count() == 2);
+
+        REQUIRE(first.dropped() == 4);
+        REQUIRE(second.dropped() == 4);
+        REQUIRE(first.flush() == 16);
+    }
+
+    std::filesystem::remove(directory / "cyanide_tracer_first.trace");
+    std::filesystem::remove(directory / "cyanide_tracer_second.trace");
+}
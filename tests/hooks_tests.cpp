@@ -1,13 +1,18 @@
 #define NOMINMAX
 
+#include <cyanide/detail/thunk_template.hpp>
 #include <cyanide/hook_impl_polyhook.hpp>
 #include <cyanide/hook_wrapper.hpp>
 
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <polyhook2/Detour/x86Detour.hpp>
 
+#include <cstdint>
 #include <functional> // std::bind_front, std::function
-#include <utility>    // std::move
+#include <limits>
+#include <stdexcept> // std::invalid_argument, std::logic_error
+#include <utility>   // std::move
 
 __declspec(noinline) int test_func_a(int x, int y)
 {
@@ -59,6 +64,49 @@ __declspec(noinline) void __stdcall test_func_c(int a, int b)
     static_cast<void>(b);
 }
 
+// Counts the copies and moves made on the way to the callback
+struct counted {
+    static inline int copies = 0;
+    static inline int moves  = 0;
+
+    int value = 0;
+
+    explicit counted(int value) : value{value} {}
+
+    counted(const counted &other) : value{other.value}
+    {
+        ++copies;
+    }
+
+    counted(counted &&other) noexcept : value{other.value}
+    {
+        ++moves;
+    }
+
+    counted &operator=(const counted &) = delete;
+    counted &operator=(counted &&)      = delete;
+};
+
+__declspec(noinline) int __cdecl test_func_d(counted c, int x)
+{
+    return c.value + x;
+}
+
+struct wide_struct {
+    int values[16];
+};
+
+__declspec(noinline) int __stdcall test_func_e(
+    wide_struct a,
+    wide_struct b,
+    int         c,
+    int         d,
+    int         e,
+    int         f)
+{
+    return a.values[0] + b.values[15] + c + d + e + f;
+}
+
 TEST_CASE("Unhooked function", "[hooks]")
 {
     constexpr int x               = 3;
@@ -153,3 +201,261 @@ TEST_CASE("Detour hooking the function returning void", "[hooks]")
 
     wrapper.install();
 }
+
+TEST_CASE("Detour passing the arguments without copies", "[hooks]")
+{
+    counted::copies = 0;
+    counted::moves  = 0;
+
+    SECTION("By reference")
+    {
+        cyanide::polyhook_x86 wrapper{
+            &test_func_d,
+            [](const counted &c, int x) { return c.value * x; }};
+
+        wrapper.install();
+
+        // Constructed right in the argument slot
+        REQUIRE(test_func_d(counted{3}, 4) == 12);
+
+        REQUIRE(counted::copies == 0);
+        REQUIRE(counted::moves == 0);
+    }
+
+    SECTION("By reference to the original")
+    {
+        cyanide::polyhook_x86 wrapper{
+            &test_func_d,
+            [](decltype(&test_func_d) orig, counted &c, int x) {
+                // The original has to get its own copy
+                return orig(c, x) + 1;
+            }};
+
+        wrapper.install();
+
+        REQUIRE(test_func_d(counted{3}, 4) == 8);
+
+        REQUIRE(counted::copies == 1);
+        REQUIRE(counted::moves == 0);
+    }
+
+    SECTION("By value")
+    {
+        cyanide::polyhook_x86 wrapper{
+            &test_func_d,
+            [](counted c, int x) { return c.value - x; }};
+
+        wrapper.install();
+
+        REQUIRE(test_func_d(counted{3}, 4) == -1);
+
+        // Into the std::function parameter and then into the callback one
+        REQUIRE(counted::copies == 0);
+        REQUIRE(counted::moves == 2);
+    }
+}
+
+TEST_CASE("Detour call overhead", "[hooks][.benchmark]")
+{
+    const wide_struct a{{1}};
+    const wide_struct b{{2}};
+
+    BENCHMARK("Unhooked")
+    {
+        return test_func_e(a, b, 1, 2, 3, 4);
+    };
+
+    cyanide::polyhook_x86 wrapper{
+        &test_func_e,
+        [](decltype(&test_func_e) orig,
+           const wide_struct     &a,
+           const wide_struct     &b,
+           int                    c,
+           int                    d,
+           int                    e,
+           int                    f) { return orig(a, b, c, d, e, f); }};
+
+    wrapper.install();
+
+    BENCHMARK("Hooked, forwarding to the original")
+    {
+        return test_func_e(a, b, 1, 2, 3, 4);
+    };
+}
+
+TEST_CASE("Prebuilt thunk of the stdcall function", "[hooks]")
+{
+    constexpr auto &thunk =
+        cyanide::detail::thunk_template_v<decltype(&test_func_c)>;
+
+    // pop eax; push imm32; push eax; jmp rel32
+    REQUIRE(thunk.size == 12);
+    REQUIRE(thunk.code[0] == 0x58);
+    REQUIRE(thunk.code[1] == 0x68);
+    REQUIRE(thunk.code[6] == 0x50);
+    REQUIRE(thunk.code[7] == 0xE9);
+    REQUIRE(thunk.wrapper_offset == 2);
+    REQUIRE(thunk.relay_offset == 8);
+}
+
+TEST_CASE("Detour bypass requires the guard", "[hooks]")
+{
+    cyanide::polyhook_x86 wrapper{&test_func_c, [](int a, int b) {
+                                      static_cast<void>(a);
+                                      static_cast<void>(b);
+                                  }};
+
+    REQUIRE_THROWS_AS(static_cast<void>(wrapper.bypass()), std::logic_error);
+}
+
+TEST_CASE("Detour uninstalled before the destruction", "[hooks]")
+{
+    constexpr int x                      = 3;
+    constexpr int y                      = 4;
+    constexpr int expected_result        = 2;
+    constexpr int expected_result_hooked = 7;
+
+    {
+        cyanide::polyhook_x86 wrapper{
+            &test_func_a,
+            [](decltype(&test_func_a) orig, int x, int y) -> int {
+                return orig(x, y) + 5;
+            }};
+
+        wrapper.install();
+        REQUIRE(test_func_a(x, y) == expected_result_hooked);
+
+        wrapper.uninstall();
+        REQUIRE(test_func_a(x, y) == expected_result);
+
+        // Nothing left to uninstall, neither here nor in the destructor
+        REQUIRE_NOTHROW(wrapper.uninstall());
+    }
+
+    REQUIRE(test_func_a(x, y) == expected_result);
+}
+
+// Thunk options are generated with Xbyak only
+#if defined CYANIDE_HOOK_JIT
+
+TEST_CASE("Detour guarding against reentrancy", "[hooks]")
+{
+    constexpr int x                      = 3;
+    constexpr int y                      = 4;
+    constexpr int expected_result        = 2;
+    constexpr int expected_result_hooked = 7;
+
+    // Without the guard the call inside would recurse infinitely
+    cyanide::polyhook_x86 wrapper{&test_func_a, [](int x, int y) -> int {
+                                      return test_func_a(x, y) + 5;
+                                  }};
+
+    wrapper.guard_reentrancy();
+    wrapper.install();
+
+    REQUIRE(test_func_a(x, y) == expected_result_hooked);
+
+    // Options can't be changed once the thunk is generated
+    REQUIRE_THROWS_AS(wrapper.guard_reentrancy(), std::logic_error);
+
+    {
+        const auto bypass = wrapper.bypass();
+
+        REQUIRE(test_func_a(x, y) == expected_result);
+    }
+
+    REQUIRE(test_func_a(x, y) == expected_result_hooked);
+}
+
+TEST_CASE("Detour filtering the callers", "[hooks]")
+{
+    constexpr int x                      = 3;
+    constexpr int y                      = 4;
+    constexpr int expected_result        = 2;
+    constexpr int expected_result_hooked = 7;
+
+    const auto callback = [](decltype(&test_func_a) orig, int x, int y) {
+        return orig(x, y) + 5;
+    };
+
+    SECTION("Matching caller")
+    {
+        cyanide::polyhook_x86 wrapper{&test_func_a, callback};
+
+        // Overlapping ones, the last one reaches almost the top of the memory
+        wrapper.filter_callers(
+            {{0x10000, 0x20000},
+             {0x1000, 0x10000},
+             {0x20000, std::numeric_limits<std::uintptr_t>::max() - 0x20000}});
+        wrapper.install();
+
+        REQUIRE(test_func_a(x, y) == expected_result_hooked);
+    }
+
+    SECTION("Foreign caller")
+    {
+        cyanide::polyhook_x86 wrapper{&test_func_a, callback};
+
+        // Nothing is ever mapped there
+        wrapper.filter_callers({{0x2000, 0x1000}, {0x0, 0x1000}});
+        wrapper.install();
+
+        REQUIRE(test_func_a(x, y) == expected_result);
+    }
+}
+
+TEST_CASE("Detour sampling the calls", "[hooks]")
+{
+    constexpr int x               = 3;
+    constexpr int y               = 4;
+    constexpr int expected_result = 2;
+    constexpr int calls           = 9;
+
+    int callback_calls = 0;
+
+    const auto callback =
+        [&callback_calls](decltype(&test_func_a) orig, int x, int y) {
+            ++callback_calls;
+            return orig(x, y);
+        };
+
+    SECTION("Every Nth call")
+    {
+        cyanide::polyhook_x86 wrapper{&test_func_a, callback};
+
+        REQUIRE_THROWS_AS(wrapper.sample_every(0), std::invalid_argument);
+
+        wrapper.sample_every(3);
+        wrapper.install();
+
+        int sum = 0;
+
+        for (int i = 0; i < calls; ++i)
+            sum += test_func_a(x, y);
+
+        REQUIRE(sum == calls * expected_result);
+
+        // 1st, 4th and 7th
+        REQUIRE(callback_calls == 3);
+    }
+
+    SECTION("Rate limit")
+    {
+        cyanide::polyhook_x86 wrapper{&test_func_a, callback};
+
+        // Way longer than the test runs
+        wrapper.limit_rate(std::numeric_limits<std::uint64_t>::max() / 2);
+        wrapper.install();
+
+        int sum = 0;
+
+        for (int i = 0; i < calls; ++i)
+            sum += test_func_a(x, y);
+
+        REQUIRE(sum == calls * expected_result);
+
+        REQUIRE(callback_calls == 1);
+    }
+}
+
+#endif
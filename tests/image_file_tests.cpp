@@ -0,0 +1,81 @@
+#define NOMINMAX
+
+#include <cyanide/image_file.hpp>
+#include <cyanide/mapped_file.hpp>
+#include <cyanide/offset_table.hpp>
+#include <cyanide/signature.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <Windows.h> // GetModuleFileNameW, GetModuleHandleW
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <stdexcept> // std::invalid_argument
+
+// Marker placed into the read-only data of the test executable
+extern const std::array<cyanide::byte_t, 12> image_marker;
+const std::array<cyanide::byte_t, 12>        image_marker{
+    0x3B, 0x91, 0xE4, 0x07, 0xC2, 0x5D, 0xA8, 0x16, 0xF0, 0x6E, 0x29, 0xB7};
+
+TEST_CASE("Resolving a signature in the image on disk", "[image_file]")
+{
+    std::array<wchar_t, MAX_PATH> path{};
+    GetModuleFileNameW(nullptr, path.data(), static_cast<DWORD>(path.size()));
+
+    const cyanide::mapped_file file{path.data()};
+    const cyanide::image_file  image{file.data()};
+
+    REQUIRE(image.format() == cyanide::image_format::pe);
+
+    const std::optional<std::uint64_t> rva = image.find_pattern(
+        cyanide::signature{"3B 91 E4 07 C2 5D A8 16 F0 6E 29 B7"});
+
+    REQUIRE(rva.has_value());
+
+    const auto module_base =
+        reinterpret_cast<std::uintptr_t>(GetModuleHandleW(nullptr));
+
+    REQUIRE(
+        module_base + *rva
+        == reinterpret_cast<std::uintptr_t>(image_marker.data()));
+
+    cyanide::offset_table table;
+    REQUIRE(table.resolve(
+        image,
+        "image_marker",
+        cyanide::signature{"3B 91 E4 07 C2 5D A8 16 F0 6E 29 B7"}));
+
+    const auto table_path =
+        std::filesystem::temp_directory_path() / "cyanide_offsets.txt";
+
+    table.save(table_path);
+    REQUIRE(cyanide::offset_table::load(table_path).find("image_marker") == rva);
+
+    std::filesystem::remove(table_path);
+}
+
+TEST_CASE("Saving and loading the offset table", "[image_file]")
+{
+    cyanide::offset_table table;
+
+    table.set("plain", 0x1000);
+    table.set("with spaces", 0x2000);
+    table.set("trailing ", 0x3000);
+    table.set("", 0);
+
+    REQUIRE_THROWS_AS(table.set("two\nlines", 0), std::invalid_argument);
+
+    const auto table_path =
+        std::filesystem::temp_directory_path() / "cyanide_offsets_names.txt";
+
+    table.save(table_path);
+
+    const auto loaded = cyanide::offset_table::load(table_path);
+
+    REQUIRE(loaded.entries() == table.entries());
+
+    std::filesystem::remove(table_path);
+}
@@ -0,0 +1,137 @@
+#include <cyanide/integrity_monitor.hpp>
+#include <cyanide/patch.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread> // std::this_thread::sleep_for
+#include <vector>
+
+TEST_CASE("Detecting the overwritten patch", "[integrity_monitor]")
+{
+    std::array<cyanide::byte_t, 32> target{};
+
+    std::vector<cyanide::integrity_violation> violations;
+
+    // The interval is long enough for the background pass not to interfere
+    cyanide::integrity_monitor monitor{
+        [&violations](const cyanide::integrity_violation &violation) {
+            violations.push_back(violation);
+        },
+        std::chrono::hours{1}};
+
+    const auto patch = cyanide::make_dynamic_patch(
+        static_cast<void *>(&target[8]),
+        0x90,
+        0x90,
+        0x90);
+
+    const auto watch = monitor.watch(patch);
+    REQUIRE(monitor.size() == 1);
+
+    REQUIRE(monitor.check() == 0);
+
+    // Bytes outside of the watched range are not of interest
+    target[0] = 1;
+    REQUIRE(monitor.check() == 0);
+
+    target[9] = 0xCC;
+    REQUIRE(monitor.check() == 1);
+    REQUIRE(violations.size() == 1);
+    REQUIRE(
+        violations[0].address == reinterpret_cast<std::uintptr_t>(&target[8]));
+    REQUIRE(
+        violations[0].expected
+        == std::vector<cyanide::byte_t>{0x90, 0x90, 0x90});
+
+    // Reported once per divergence
+    REQUIRE(monitor.check() == 0);
+
+    target[9] = 0x90;
+    REQUIRE(monitor.check() == 0);
+
+    target[10] = 0xCC;
+    REQUIRE(monitor.check() == 1);
+}
+
+namespace {
+struct installed_hook {
+    const void *target = nullptr;
+
+    [[nodiscard]] const void *source() const
+    {
+        return target;
+    }
+};
+} // namespace
+
+TEST_CASE("Watching the installed hook", "[integrity_monitor]")
+{
+    // jmp rel32, the rest of the overwritten instruction as a NOP, then ret
+    std::array<cyanide::byte_t, 32> target{
+        0xE9, 0x00, 0x00, 0x00, 0x00, 0x66, 0x90, 0xC3};
+
+    std::vector<cyanide::integrity_violation> violations;
+
+    cyanide::integrity_monitor monitor{
+        [&violations](const cyanide::integrity_violation &violation) {
+            violations.push_back(violation);
+        },
+        std::chrono::hours{1}};
+
+    const auto watch = monitor.watch(installed_hook{target.data()});
+
+    // Past the padding
+    target[7] = 0xCC;
+    REQUIRE(monitor.check() == 0);
+
+    target[6] = 0xCC;
+    REQUIRE(monitor.check() == 1);
+    REQUIRE(violations[0].expected.size() == 7);
+}
+
+TEST_CASE("Unwatching the ranges", "[integrity_monitor]")
+{
+    std::array<cyanide::byte_t, 16> target{};
+
+    cyanide::integrity_monitor monitor{
+        [](const cyanide::integrity_violation &) {},
+        std::chrono::hours{1}};
+
+    {
+        const auto first  = monitor.watch(&target[0], 4);
+        const auto second = monitor.watch(&target[8], 4);
+        REQUIRE(monitor.size() == 2);
+
+        target[0] = 1;
+        target[8] = 1;
+    }
+
+    REQUIRE(monitor.size() == 0);
+    REQUIRE(monitor.check() == 0);
+}
+
+TEST_CASE("Checking in the background", "[integrity_monitor]")
+{
+    std::array<cyanide::byte_t, 16> target{};
+
+    std::atomic<int> violations = 0;
+
+    cyanide::integrity_monitor monitor{
+        [&violations](const cyanide::integrity_violation &) {
+            ++violations;
+        },
+        std::chrono::milliseconds{1}};
+
+    const auto watch = monitor.watch(target.data(), target.size());
+
+    target[5] = 1;
+
+    for (int i = 0; i < 1000 && violations == 0; ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+
+    REQUIRE(violations == 1);
+}
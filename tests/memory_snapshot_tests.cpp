@@ -0,0 +1,160 @@
+#include <cyanide/detail/crc32c.hpp>
+#include <cyanide/memory_snapshot.hpp>
+#include <cyanide/patch.hpp>
+#include <cyanide/process_memory.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring> // std::memcpy
+#include <span>
+#include <vector>
+
+namespace {
+class buffer_process {
+public:
+    std::size_t
+    read(std::uintptr_t address, std::span<cyanide::byte_t> buffer) const
+    {
+        std::memcpy(
+            buffer.data(),
+            reinterpret_cast<const void *>(address),
+            buffer.size());
+
+        return buffer.size();
+    }
+};
+
+// Page aligned buffer of the specified number of pages
+struct pages {
+    explicit pages(std::size_t count) : storage((count + 1) * page_size) {}
+
+    static constexpr std::size_t page_size = 0x1000;
+
+    std::vector<cyanide::byte_t> storage;
+
+    cyanide::byte_t *data()
+    {
+        const auto address = reinterpret_cast<std::uintptr_t>(storage.data());
+
+        return storage.data() + (page_size - address % page_size) % page_size;
+    }
+
+    cyanide::memory_region region(std::size_t count)
+    {
+        return {reinterpret_cast<std::uintptr_t>(data()), count * page_size};
+    }
+};
+} // namespace
+
+TEST_CASE("CRC32C checksum", "[memory_snapshot]")
+{
+    const char *text  = "123456789";
+    const auto *bytes = reinterpret_cast<const cyanide::byte_t *>(text);
+
+    REQUIRE(cyanide::detail::crc32c({bytes, 9}) == 0xE3069283);
+
+    // Continuing from the checksum of the first part
+    const std::uint32_t head = cyanide::detail::crc32c({bytes, 4});
+    REQUIRE(cyanide::detail::crc32c({bytes + 4, 5}, head) == 0xE3069283);
+}
+
+TEST_CASE("Diffing the snapshots", "[memory_snapshot]")
+{
+    pages          memory{4};
+    buffer_process process;
+
+    const cyanide::memory_region region = memory.region(4);
+
+    cyanide::memory_snapshot<buffer_process> snapshot{process, {&region, 1}};
+    REQUIRE(snapshot.page_count() == 4);
+
+    REQUIRE(snapshot.update().empty());
+    REQUIRE(snapshot.changed_page_count() == 0);
+
+    cyanide::byte_t *data = memory.data();
+
+    data[10] = 1;
+    data[11] = 2;
+    data[20] = 3;
+
+    // Crosses the boundary of the second and the third pages
+    data[0x1FFF] = 4;
+    data[0x2000] = 5;
+
+    const auto diffs = snapshot.update();
+    REQUIRE(snapshot.changed_page_count() == 3);
+    REQUIRE(diffs.size() == 3);
+
+    using bytes = std::vector<cyanide::byte_t>;
+
+    REQUIRE(diffs[0].address == region.base + 10);
+    REQUIRE(diffs[0].previous == bytes(2, 0));
+    REQUIRE(diffs[0].current == bytes{1, 2});
+
+    REQUIRE(diffs[1].address == region.base + 20);
+    REQUIRE(diffs[1].current == bytes{3});
+
+    REQUIRE(diffs[2].address == region.base + 0x1FFF);
+    REQUIRE(diffs[2].current == bytes{4, 5});
+
+    // The snapshot is up to date now
+    REQUIRE(snapshot.update().empty());
+}
+
+TEST_CASE("Updating only the dirty pages", "[memory_snapshot]")
+{
+    pages          memory{4};
+    buffer_process process;
+
+    const cyanide::memory_region region = memory.region(4);
+
+    cyanide::memory_snapshot<buffer_process> snapshot{process, {&region, 1}};
+
+    cyanide::byte_t *data = memory.data();
+
+    data[0x1010] = 1;
+    data[0x3010] = 2;
+
+    const std::uintptr_t dirty[] = {region.base + 0x1800, 0};
+
+    const auto diffs = snapshot.update(dirty);
+    REQUIRE(diffs.size() == 1);
+    REQUIRE(diffs[0].address == region.base + 0x1010);
+
+    // The other page is still there to be found
+    REQUIRE(snapshot.update().size() == 1);
+}
+
+TEST_CASE("Replaying the diffs as patches", "[memory_snapshot]")
+{
+    pages          memory{1};
+    buffer_process process;
+
+    const cyanide::memory_region region = memory.region(1);
+
+    cyanide::memory_snapshot<buffer_process> snapshot{process, {&region, 1}};
+
+    cyanide::byte_t *data = memory.data();
+
+    data[100] = 0xAA;
+    data[101] = 0xBB;
+
+    const auto diffs = snapshot.update();
+    REQUIRE(diffs.size() == 1);
+
+    {
+        // Revert the change for the lifetime of the patch
+        const cyanide::patch<> revert{
+            reinterpret_cast<void *>(diffs[0].address),
+            diffs[0].previous,
+            false};
+
+        REQUIRE(data[100] == 0);
+        REQUIRE(data[101] == 0);
+    }
+
+    REQUIRE(data[100] == 0xAA);
+    REQUIRE(data[101] == 0xBB);
+}
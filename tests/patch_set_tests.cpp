@@ -0,0 +1,181 @@
+#include <cyanide/mapped_file.hpp>
+#include <cyanide/patch_set.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+#include <utility> // std::move
+#include <vector>
+
+TEST_CASE("Applying a patch set", "[patch_set]")
+{
+    // Stands for a module, two pages long to cross the page boundary
+    alignas(0x1000) static std::array<cyanide::byte_t, 0x2000> module{};
+
+    module[0x10]   = 0x74;
+    module[0xFFF]  = 0x75;
+    module[0x1000] = 0x0C;
+
+    const std::array<cyanide::byte_t, 1> je{0x74};
+    const std::array<cyanide::byte_t, 1> jmp{0xEB};
+    const std::array<cyanide::byte_t, 2> jne{0x75, 0x0C};
+    const std::array<cyanide::byte_t, 2> nops{0x90, 0x90};
+
+    cyanide::patch_set_builder builder;
+
+    // Out of order, the builder sorts them
+    builder.add("game.dll", 0xFFF, jne, nops);
+    builder.add("game.dll", 0x10, je, jmp);
+
+    std::vector<cyanide::byte_t> file = builder.build();
+
+    const cyanide::patch_set set{file};
+
+    REQUIRE(set.module_count() == 1);
+    REQUIRE(set.module_name(0) == "game.dll");
+    REQUIRE(set.size() == 2);
+    REQUIRE(set[0].offset == 0x10);
+    REQUIRE(set[1].replacement[1] == 0x90);
+
+    const std::array<std::uintptr_t, 1> bases{
+        reinterpret_cast<std::uintptr_t>(module.data())};
+
+    SECTION("Applying and reverting")
+    {
+        {
+            cyanide::applied_patch_set applied{set, bases};
+
+            REQUIRE(applied.size() == 2);
+            REQUIRE(module[0x10] == 0xEB);
+            REQUIRE(module[0xFFF] == 0x90);
+            REQUIRE(module[0x1000] == 0x90);
+
+            const cyanide::applied_patch_set moved{std::move(applied)};
+            REQUIRE(module[0x10] == 0xEB);
+        }
+
+        REQUIRE(module[0x10] == 0x74);
+        REQUIRE(module[0xFFF] == 0x75);
+        REQUIRE(module[0x1000] == 0x0C);
+    }
+
+    SECTION("Mismatching bytes")
+    {
+        module[0x1000] = 0x0D;
+
+        REQUIRE_THROWS_AS(
+            cyanide::applied_patch_set(set, bases),
+            std::runtime_error);
+
+        // Nothing has been written, even for the matching entry
+        REQUIRE(module[0x10] == 0x74);
+
+        module[0x1000] = 0x0C;
+    }
+
+    SECTION("Hot-swapping")
+    {
+        cyanide::applied_patch_set applied{set, bases};
+
+        const std::array<cyanide::byte_t, 1> int3{0xCC};
+
+        cyanide::patch_set_builder next_builder;
+        next_builder.add("game.dll", 0x10, je, int3);
+
+        const std::vector<cyanide::byte_t> next_file = next_builder.build();
+        const cyanide::patch_set           next{next_file};
+
+        applied.replace(next, bases);
+
+        REQUIRE(applied.size() == 1);
+        REQUIRE(module[0x10] == 0xCC);
+        REQUIRE(module[0xFFF] == 0x75);
+
+        // Doesn't match the original bytes, the current set stays
+        cyanide::patch_set_builder wrong_builder;
+        wrong_builder.add("game.dll", 0x10, jmp, int3);
+
+        const std::vector<cyanide::byte_t> wrong_file = wrong_builder.build();
+        const cyanide::patch_set           wrong{wrong_file};
+
+        REQUIRE_THROWS_AS(applied.replace(wrong, bases), std::runtime_error);
+        REQUIRE(module[0x10] == 0xCC);
+
+        applied.revert();
+        REQUIRE(module[0x10] == 0x74);
+    }
+
+    SECTION("Missing module")
+    {
+        const std::array<std::uintptr_t, 1> missing{0};
+
+        REQUIRE_THROWS_AS(
+            cyanide::applied_patch_set(set, missing),
+            std::invalid_argument);
+    }
+
+    SECTION("Corrupted file")
+    {
+        file.back() ^= 0xFF;
+
+        REQUIRE_THROWS_AS(cyanide::patch_set{file}, std::runtime_error);
+
+        file.pop_back();
+
+        REQUIRE_THROWS_AS(cyanide::patch_set{file}, std::runtime_error);
+    }
+}
+
+TEST_CASE("Building an invalid patch set", "[patch_set]")
+{
+    const std::array<cyanide::byte_t, 4> bytes{};
+    const std::array<cyanide::byte_t, 2> short_bytes{};
+
+    cyanide::patch_set_builder builder;
+
+    REQUIRE_THROWS_AS(
+        builder.add("a.dll", 0, bytes, short_bytes),
+        std::invalid_argument);
+
+    builder.add("a.dll", 0x100, bytes, bytes);
+    builder.add("b.dll", 0x102, bytes, bytes);
+    builder.add("a.dll", 0x102, bytes, bytes);
+
+    REQUIRE_THROWS_AS(builder.build(), std::invalid_argument);
+}
+
+TEST_CASE("Loading a patch set from the file", "[patch_set]")
+{
+    std::array<cyanide::byte_t, 16> target{};
+
+    const std::array<cyanide::byte_t, 4> original{};
+    const std::array<cyanide::byte_t, 4> replacement{1, 2, 3, 4};
+
+    cyanide::patch_set_builder builder;
+    builder.add("target", 8, original, replacement);
+
+    const std::filesystem::path path =
+        std::filesystem::temp_directory_path() / "cyanide_patches.cyps";
+
+    builder.save(path);
+
+    {
+        const cyanide::mapped_file file{path};
+        const cyanide::patch_set   set{file.data()};
+
+        const std::array<std::uintptr_t, 1> bases{
+            reinterpret_cast<std::uintptr_t>(target.data())};
+
+        const cyanide::applied_patch_set applied{set, bases};
+
+        REQUIRE(target[8] == 1);
+        REQUIRE(target[11] == 4);
+    }
+
+    REQUIRE(target[8] == 0);
+
+    std::filesystem::remove(path);
+}
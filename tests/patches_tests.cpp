@@ -1,8 +1,17 @@
+#include <cyanide/code_patch.hpp>
+#include <cyanide/instruction_length.hpp>
 #include <cyanide/patch.hpp>
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <algorithm> // std::equal
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <cstring> // std::memcpy
+#include <span>
+#include <stdexcept>
+#include <vector>
 
 TEST_CASE("Applying a patch", "[patches]")
 {
@@ -26,3 +35,206 @@ TEST_CASE("Applying a patch", "[patches]")
     REQUIRE(target_dynamic == 5);
     REQUIRE(target_static == 10);
 }
+
+TEST_CASE("Decoding the instruction lengths", "[patches]")
+{
+    const auto length = [](std::vector<cyanide::byte_t> code) {
+        return cyanide::instruction_length(code);
+    };
+
+    REQUIRE(length({0x55}) == 1);                         // push ebp
+    REQUIRE(length({0x8B, 0xEC}) == 2);                   // mov ebp, esp
+    REQUIRE(length({0x83, 0xEC, 0x10}) == 3);             // sub esp, 10h
+    REQUIRE(length({0x66, 0x81, 0xEC, 0x00, 0x01}) == 5); // sub sp, 100h
+    REQUIRE(length({0x8B, 0x44, 0x24, 0x08}) == 4);       // SIB, disp8
+    REQUIRE(length({0x8B, 0x05, 1, 2, 3, 4}) == 6);       // disp32
+    REQUIRE(length({0xC7, 0x44, 0x24, 0x04, 1, 2, 3, 4}) == 8);
+    REQUIRE(length({0xF6, 0xC1, 0x01}) == 3);             // test cl, 1
+    REQUIRE(length({0xF6, 0xD1}) == 2);                   // not cl
+    REQUIRE(length({0x64, 0xA1, 0x30, 0, 0, 0}) == 6);    // fs:[30h]
+    REQUIRE(length({0x0F, 0x84, 1, 2, 3, 4}) == 6);       // jz rel32
+    REQUIRE(length({0x66, 0x0F, 0x3A, 0x0F, 0xC1, 0x08}) == 6);
+    REQUIRE(length({0xC5, 0xFC, 0x28, 0xC1}) == 4);       // vmovaps
+    REQUIRE(length({0xC4, 0xE3, 0x7D, 0x18, 0xC1, 0x01}) == 6);
+    REQUIRE(length({0xC4, 0x06}) == 2);                   // les, not VEX
+
+    // Truncated
+    REQUIRE(length({0xE8, 1, 2}) == 0);
+
+    // Longer than 15 bytes
+    REQUIRE(length(std::vector<cyanide::byte_t>(15, 0x66)) == 0);
+
+    for (std::size_t size = 1; size <= cyanide::nop_forms.size(); ++size)
+    {
+        REQUIRE(
+            cyanide::instruction_length(cyanide::nop_forms[size - 1]) == size);
+    }
+}
+
+TEST_CASE("Applying a code patch", "[patches]")
+{
+    // push ebp; mov ebp, esp; sub esp, 10h; call rel32; test cl, 1; ret
+    std::array<cyanide::byte_t, 15> code{
+        0x55, 0x8B, 0xEC, 0x83, 0xEC, 0x10, 0xE8, 0x01,
+        0x02, 0x03, 0x04, 0xF6, 0xC1, 0x01, 0xC3};
+
+    const auto original = code;
+
+    SECTION("NOPs")
+    {
+        {
+            // Ends in the middle of mov ebp, esp
+            const auto patch = cyanide::make_nop_patch(code.data(), 2);
+
+            REQUIRE(patch.size() == 3);
+            REQUIRE(code[0] == 0x90);
+            REQUIRE(code[1] == 0x66);
+            REQUIRE(code[3] == 0x83);
+        }
+
+        REQUIRE(code == original);
+
+        // A NOP per instruction, of 1, 2, 3 and 5 bytes
+        const auto patch = cyanide::make_nop_patch(code.data(), 7);
+
+        REQUIRE(patch.size() == 11);
+        REQUIRE(code[0] == 0x90);
+        REQUIRE(code[1] == 0x66);
+        REQUIRE(code[3] == 0x0F);
+        REQUIRE(cyanide::instruction_length(std::span{code}.subspan(6)) == 5);
+    }
+
+    SECTION("Replacement code")
+    {
+        // call -> xor eax, eax, the rest of the call becomes a NOP
+        const std::array<cyanide::byte_t, 2> replacement{0x31, 0xC0};
+
+        const auto patch =
+            cyanide::make_code_patch(code.data() + 6, replacement);
+
+        REQUIRE(patch.size() == 5);
+        REQUIRE(code[6] == 0x31);
+        REQUIRE(code[8] == 0x0F);
+        REQUIRE(code[11] == 0xF6);
+
+        REQUIRE_THROWS_AS(
+            cyanide::instruction_boundary(
+                std::vector<cyanide::byte_t>(16, 0x66).data(),
+                1),
+            std::runtime_error);
+    }
+}
+
+TEST_CASE("Jumping over a long NOP region", "[patches]")
+{
+    // 100 x mov eax, [disp32]
+    std::vector<cyanide::byte_t> code;
+
+    for (int i = 0; i < 100; ++i)
+        code.insert(code.end(), {0xA1, 0x00, 0x00, 0x00, 0x00});
+
+    {
+        const auto patch = cyanide::make_nop_patch(code.data(), 48);
+
+        REQUIRE(patch.size() == 50);
+        REQUIRE(code[0] == 0xEB);
+        REQUIRE(code[1] == 48);
+        REQUIRE(code[2] == 0x0F);
+        REQUIRE(cyanide::instruction_length(std::span{code}.subspan(2)) == 3);
+        REQUIRE(code[45] == 0x0F);
+        REQUIRE(code[50] == 0xA1);
+    }
+
+    const auto patch = cyanide::make_nop_patch(code.data(), 300);
+
+    REQUIRE(code[0] == 0xE9);
+    REQUIRE(code[1] == 300 - 5 - 256);
+    REQUIRE(code[2] == 1);
+}
+
+TEST_CASE("Branching into a long NOP region", "[patches]")
+{
+    // push ebp; push esi; push edi; mov ebp, esp; 100 x mov eax, [disp32]
+    std::vector<cyanide::byte_t> code{0x55, 0x56, 0x57, 0x8B, 0xEC};
+
+    for (int i = 0; i < 100; ++i)
+        code.insert(code.end(), {0xA1, 0x00, 0x00, 0x00, 0x00});
+
+    const auto original = code;
+
+    const auto length_at = [](const auto &buffer, std::size_t offset) {
+        return cyanide::instruction_length(std::span{buffer}.subspan(offset));
+    };
+
+    const auto is_nop = [&](std::size_t offset, std::size_t length) {
+        const auto &form = cyanide::nop_forms[length - 1];
+
+        return std::equal(
+            form.begin(),
+            form.begin() + static_cast<std::ptrdiff_t>(length),
+            code.begin() + static_cast<std::ptrdiff_t>(offset));
+    };
+
+    // Every original instruction starts a NOP, or the jmp to the end
+    const auto check = [&](std::size_t size) {
+        std::size_t jumps = 0;
+
+        for (std::size_t offset = 0; offset < size;)
+        {
+            const std::size_t next = offset + length_at(original, offset);
+            std::size_t       end  = offset + length_at(code, offset);
+
+            if (code[offset] == 0xEB)
+            {
+                const auto displacement =
+                    static_cast<std::int8_t>(code[offset + 1]);
+
+                REQUIRE(end + static_cast<std::size_t>(displacement) == size);
+                ++jumps;
+            }
+            else if (code[offset] == 0xE9)
+            {
+                std::int32_t displacement = 0;
+                std::memcpy(&displacement, &code[offset + 1], 4);
+
+                REQUIRE(end + static_cast<std::size_t>(displacement) == size);
+                ++jumps;
+            }
+            else
+            {
+                REQUIRE(is_nop(offset, end - offset));
+            }
+
+            // The rest of the instruction is NOPs too
+            while (end < next)
+            {
+                const std::size_t length = length_at(code, end);
+
+                REQUIRE(is_nop(end, length));
+                end += length;
+            }
+
+            REQUIRE(end == next);
+
+            offset = next;
+        }
+
+        REQUIRE(jumps == 1);
+    };
+
+    {
+        // rel8 in place of mov ebp, esp
+        const auto patch = cyanide::make_nop_patch(code.data(), 100);
+
+        REQUIRE(patch.size() == 100);
+        REQUIRE(code[3] == 0xEB);
+        check(100);
+    }
+
+    // Too far for rel8, rel32 in place of the first mov eax, [disp32]
+    const auto patch = cyanide::make_nop_patch(code.data(), 300);
+
+    REQUIRE(patch.size() == 300);
+    REQUIRE(code[5] == 0xE9);
+    check(300);
+}
@@ -0,0 +1,134 @@
+#include <cyanide/pointer_chain.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace {
+struct player {
+    int padding[2];
+    int health;
+};
+
+struct world {
+    char    padding[0x10];
+    player *local_player;
+};
+
+struct game {
+    char   padding[0x8];
+    world *current_world;
+};
+
+template <typename T>
+std::uintptr_t address_of(T &object)
+{
+    return reinterpret_cast<std::uintptr_t>(&object);
+}
+} // namespace
+
+TEST_CASE("Resolving a pointer chain", "[pointer_chain]")
+{
+    player p{{}, 100};
+    world  w{{}, &p};
+    game   g{{}, &w};
+
+    cyanide::pointer_chain<0x8, 0x10, 0x8> chain{address_of(g)};
+
+    REQUIRE(chain.read<int>() == 100);
+    REQUIRE(chain.pointer(0) == address_of(w));
+    REQUIRE(chain.pointer(1) == address_of(p));
+
+    // The cached pointers are used until invalidated
+    player other{{}, 50};
+    w.local_player = &other;
+    REQUIRE(chain.read<int>() == 100);
+
+    chain.invalidate();
+    REQUIRE(chain.read<int>() == 50);
+
+    // Broken chain
+    w.local_player = nullptr;
+    chain.invalidate();
+    REQUIRE(chain.read<int>() == std::nullopt);
+}
+
+TEST_CASE("Pointer chain invalidation by generation", "[pointer_chain]")
+{
+    std::atomic<std::uint64_t> generation = 0;
+
+    player p{{}, 100};
+    player other{{}, 50};
+    world  w{{}, &p};
+    game   g{{}, &w};
+
+    cyanide::basic_pointer_chain<
+        cyanide::generation_invalidation,
+        0x8,
+        0x10,
+        0x8>
+        chain{address_of(g), generation};
+
+    REQUIRE(chain.read<int>() == 100);
+
+    w.local_player = &other;
+    REQUIRE(chain.read<int>() == 100);
+
+    ++generation;
+    REQUIRE(chain.read<int>() == 50);
+}
+
+TEST_CASE("Pointer chain invalidation by time-to-live", "[pointer_chain]")
+{
+    player p{{}, 100};
+    world  w{{}, &p};
+    game   g{{}, &w};
+
+    cyanide::basic_pointer_chain<cyanide::ttl_invalidation, 0x8, 0x10, 0x8>
+        chain{address_of(g), std::chrono::steady_clock::duration::zero()};
+
+    REQUIRE(chain.read<int>() == 100);
+    REQUIRE_FALSE(chain.is_cached());
+}
+
+TEST_CASE("Resolving many pointer chains at once", "[pointer_chain]")
+{
+    std::array<player, 4> players{};
+    std::array<world, 4>  worlds{};
+    std::array<game, 4>   games{};
+
+    using chain_t = cyanide::pointer_chain<0x8, 0x10, 0x8>;
+
+    std::vector<chain_t> chains;
+
+    for (std::size_t i = 0; i < games.size(); ++i)
+    {
+        players[i].health      = static_cast<int>(i) * 10;
+        worlds[i].local_player = &players[i];
+        games[i].current_world = &worlds[i];
+
+        chains.emplace_back(address_of(games[i]));
+    }
+
+    // Broken one
+    worlds[2].local_player = nullptr;
+
+    chain_t::resolve_all(chains);
+
+    for (std::size_t i = 0; i < chains.size(); ++i)
+    {
+        if (i == 2)
+        {
+            REQUIRE_FALSE(chains[i].is_cached());
+            continue;
+        }
+
+        REQUIRE(chains[i].is_cached());
+        REQUIRE(chains[i].resolve() == address_of(players[i].health));
+    }
+}
@@ -0,0 +1,120 @@
+#include <cyanide/pointer_scanner.hpp>
+#include <cyanide/process_memory.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm> // std::any_of
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring> // std::memcpy
+#include <filesystem>
+#include <span>
+#include <vector>
+
+namespace {
+// Accessor exposing only the specified buffers of the current process, so
+// that the test doesn't depend on the rest of the address space
+class fake_process {
+public:
+    std::vector<cyanide::memory_region> regions;
+    std::vector<cyanide::module_info>   module_list;
+
+    std::size_t
+    read(std::uintptr_t address, std::span<cyanide::byte_t> buffer) const
+    {
+        std::memcpy(
+            buffer.data(),
+            reinterpret_cast<const void *>(address),
+            buffer.size());
+
+        return buffer.size();
+    }
+
+    std::vector<cyanide::memory_region> readable_regions() const
+    {
+        return regions;
+    }
+
+    std::vector<cyanide::module_info> modules() const
+    {
+        return module_list;
+    }
+};
+
+template <typename T>
+std::uintptr_t address_of(const T &object)
+{
+    return reinterpret_cast<std::uintptr_t>(&object);
+}
+
+template <typename T>
+cyanide::memory_region region_of(const T &object)
+{
+    return {address_of(object), sizeof(object)};
+}
+} // namespace
+
+TEST_CASE("Finding pointer paths", "[pointer_scanner]")
+{
+    // static_data -> heap_a -> heap_b -> target
+    std::array<std::uintptr_t, 16> static_data{};
+    std::array<std::uintptr_t, 16> heap_a{};
+    std::array<std::uintptr_t, 16> heap_b{};
+
+    const std::uintptr_t target = address_of(heap_b[6]);
+
+    heap_a[3]      = address_of(heap_b[2]);
+    static_data[5] = address_of(heap_a[1]);
+
+    fake_process process;
+    process.regions = {region_of(static_data), region_of(heap_a), region_of(heap_b)};
+    std::sort(
+        process.regions.begin(),
+        process.regions.end(),
+        [](const auto &lhs, const auto &rhs) { return lhs.base < rhs.base; });
+    process.module_list = {
+        {"game.exe", address_of(static_data), sizeof(static_data)}};
+
+    const cyanide::pointer_scanner scanner{process};
+
+    cyanide::pointer_scanner::options options;
+    options.max_depth  = 3;
+    options.max_offset = 0x40;
+    options.threads    = 2;
+
+    const cyanide::pointer_scan_result result =
+        scanner.find_paths(target, options);
+
+    REQUIRE_FALSE(result.paths.empty());
+
+    constexpr std::ptrdiff_t pointer_size = sizeof(std::uintptr_t);
+
+    const bool found = std::any_of(
+        result.paths.begin(),
+        result.paths.end(),
+        [&](const cyanide::pointer_path &path) {
+            return path.module_offset == 5 * sizeof(std::uintptr_t)
+                && path.offsets
+                       == std::vector<std::ptrdiff_t>{
+                           2 * pointer_size,
+                           4 * pointer_size};
+        });
+
+    REQUIRE(found);
+
+    for (const auto &path : result.paths)
+        REQUIRE(path.resolve(address_of(static_data), process) == target);
+
+    const auto file_path =
+        std::filesystem::temp_directory_path() / "cyanide_pointers.bin";
+
+    result.save(file_path);
+
+    const auto loaded = cyanide::pointer_scan_result::load(file_path);
+    REQUIRE(loaded.modules == result.modules);
+    REQUIRE(loaded.paths.size() == result.paths.size());
+    REQUIRE(loaded.paths[0].offsets == result.paths[0].offsets);
+
+    std::filesystem::remove(file_path);
+}
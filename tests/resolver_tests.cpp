@@ -0,0 +1,84 @@
+#include <cyanide/resolver.hpp>
+#include <cyanide/scanner.hpp>
+#include <cyanide/signature.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cstdint>
+#include <cstring> // std::memcpy
+#include <vector>
+
+namespace {
+// call rel32 followed by mov eax, [abs32], both placed at odd offsets so that
+// the operands are unaligned
+struct code_block {
+    std::array<cyanide::byte_t, 64> code{};
+    std::uintptr_t                  global = 0xDEADBEEF;
+
+    code_block()
+    {
+        code.fill(0x90);
+
+        // call code[40]
+        code[3]                  = 0xE8;
+        const std::int32_t rel32 = 40 - (3 + 5);
+        std::memcpy(&code[4], &rel32, sizeof(rel32));
+
+        // mov eax, [&global]
+        code[21]                    = 0xA1;
+        const std::uintptr_t abs32 = reinterpret_cast<std::uintptr_t>(&global);
+        std::memcpy(&code[22], &abs32, sizeof(abs32));
+    }
+};
+} // namespace
+
+TEST_CASE("Following a relative call", "[resolver]")
+{
+    const code_block block;
+
+    const cyanide::byte_t *match =
+        cyanide::find_pattern(block.code, cyanide::signature{"E8 ?? ?? ?? ??"});
+
+    REQUIRE(match == &block.code[3]);
+    REQUIRE(
+        cyanide::resolver{}.rel32(1).resolve(match)
+        == reinterpret_cast<std::uintptr_t>(&block.code[40]));
+}
+
+TEST_CASE("Dereferencing an absolute operand", "[resolver]")
+{
+    const code_block block;
+
+    const cyanide::byte_t *match =
+        cyanide::find_pattern(block.code, cyanide::signature{"A1"});
+
+    const auto global_address =
+        cyanide::resolver{}.add(1).deref().resolve(match);
+    REQUIRE(global_address == reinterpret_cast<std::uintptr_t>(&block.global));
+
+    const auto global_value =
+        cyanide::resolver{}.add(1).deref().deref().resolve(match);
+    REQUIRE(global_value == 0xDEADBEEF);
+}
+
+TEST_CASE("Resolving many matches at once", "[resolver]")
+{
+    const std::array<code_block, 3> blocks{};
+
+    std::vector<const cyanide::byte_t *> matches;
+
+    for (const auto &block : blocks)
+        matches.push_back(&block.code[3]);
+
+    const std::vector<std::uintptr_t> targets =
+        cyanide::resolver{}.rel32(1).add(-40).resolve_all(matches);
+
+    REQUIRE(targets.size() == blocks.size());
+
+    for (std::size_t i = 0; i < blocks.size(); ++i)
+    {
+        REQUIRE(
+            targets[i] == reinterpret_cast<std::uintptr_t>(blocks[i].code.data()));
+    }
+}
@@ -0,0 +1,177 @@
+#define NOMINMAX
+
+#include <cyanide/process_memory.hpp>
+#include <cyanide/scanner.hpp>
+#include <cyanide/signature.hpp>
+#include <cyanide/stream_scanner.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <Windows.h> // GetCurrentProcessId
+
+#include <algorithm> // std::ranges::find_if
+#include <array>
+#include <cstdint>
+#include <iterator> // std::ranges::distance
+#include <ranges>   // std::views::filter, std::views::take
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("Parsing a signature", "[scanner]")
+{
+    const cyanide::signature sig{"E8 ?? ?? ? ?? 8b 45"};
+
+    REQUIRE(sig.size() == 7);
+    REQUIRE(sig.bytes()[0] == 0xE8);
+    REQUIRE(sig.bytes()[6] == 0x45);
+    REQUIRE(sig.mask()[1] == 0x00);
+    REQUIRE(sig.mask()[5] == 0xFF);
+
+    REQUIRE_THROWS_AS(cyanide::signature{"E8 XY"}, std::invalid_argument);
+    REQUIRE_THROWS_AS(cyanide::signature{""}, std::invalid_argument);
+}
+
+TEST_CASE("Choosing the rarest anchors", "[scanner]")
+{
+    // 9A and 48 (dec eax, not a prefix in 32-bit code) are the rarest bytes
+    // among these
+    const cyanide::signature sig{"00 48 8B ?? 0F 9A 00"};
+
+    REQUIRE(sig.anchor() == 5);
+    REQUIRE(sig.second_anchor() == 1);
+
+    // Padding and the frame prologue, int3 is everywhere between functions
+    const cyanide::signature prologue{"CC CC 55 8B EC"};
+
+    REQUIRE(prologue.bytes()[prologue.anchor()] != 0xCC);
+    REQUIRE(prologue.bytes()[prologue.second_anchor()] != 0xCC);
+
+    // Single fixed byte is both anchors
+    const cyanide::signature single{"?? FF ??"};
+
+    REQUIRE(single.anchor() == 1);
+    REQUIRE(single.second_anchor() == 1);
+
+    // Anchors after the beginning of the pattern must not skip the matches
+    // at the very start and the very end of the data
+    std::vector<cyanide::byte_t> data(40, 0x00);
+
+    data[0]  = 0x48;
+    data[1]  = 0x8B;
+    data[4]  = 0x9A;
+    data[33] = 0x48;
+    data[34] = 0x8B;
+    data[37] = 0x9A;
+
+    const cyanide::signature tail{"?? 48 8B ?? ?? 9A"};
+    const auto               matches = cyanide::find_all_patterns(data, tail);
+
+    REQUIRE(matches.size() == 1);
+    REQUIRE(matches[0] == &data[32]);
+
+    const cyanide::signature head{"48 8B ?? ?? 9A"};
+    REQUIRE(cyanide::find_all_patterns(data, head).size() == 2);
+}
+
+TEST_CASE("Finding a pattern", "[scanner]")
+{
+    std::vector<cyanide::byte_t> data(100, 0xCC);
+
+    data[40] = 0xE8;
+    data[45] = 0x8B;
+    data[90] = 0xE8;
+    data[95] = 0x8B;
+
+    const cyanide::signature sig{"E8 ?? ?? ?? ?? 8B"};
+
+    REQUIRE(cyanide::find_pattern(data, sig) == &data[40]);
+
+    const auto matches = cyanide::find_all_patterns(data, sig);
+    REQUIRE(matches.size() == 2);
+    REQUIRE(matches[1] == &data[90]);
+
+    // The second occurrence doesn't fit entirely
+    data.resize(95);
+    REQUIRE(cyanide::find_all_patterns(data, sig).size() == 1);
+}
+
+TEST_CASE("Finding a pattern starting with a wildcard", "[scanner]")
+{
+    const std::array<cyanide::byte_t, 6> data{0x01, 0x02, 0x03, 0x01, 0x02, 0x04};
+
+    const cyanide::signature sig{"?? 02 04"};
+
+    REQUIRE(cyanide::find_pattern(data, sig) == &data[3]);
+}
+
+TEST_CASE("Finding patterns lazily", "[scanner]")
+{
+    std::vector<cyanide::byte_t> data(64, 0xCC);
+
+    data[10] = 0xE8;
+    data[20] = 0xE8;
+    data[30] = 0xE8;
+    data[31] = 0x01;
+
+    const cyanide::signature sig{"E8"};
+
+    auto matches = cyanide::find_patterns(data, sig);
+    REQUIRE(std::ranges::distance(matches) == 3);
+    REQUIRE(matches.front() == &data[10]);
+
+    // The scan stops at the first match passing the predicate
+    const auto it =
+        std::ranges::find_if(matches, [](const cyanide::byte_t *match) {
+            return match[1] == 0x01;
+        });
+    REQUIRE(*it == &data[30]);
+
+    auto filtered = cyanide::find_patterns(data, sig)
+                  | std::views::filter([&data](const cyanide::byte_t *match) {
+                        return match != &data[10];
+                    })
+                  | std::views::take(1);
+    REQUIRE(*filtered.begin() == &data[20]);
+
+    REQUIRE(cyanide::find_patterns(std::span{data}.first(10), sig).empty());
+
+#if defined __cpp_lib_generator
+    auto generated =
+        cyanide::generate_patterns(data, cyanide::signature{"E8 01"});
+    REQUIRE(*generated.begin() == &data[30]);
+#endif
+}
+
+TEST_CASE("Streaming scan across window boundaries", "[scanner]")
+{
+    static std::array<cyanide::byte_t, 4096> target{};
+
+    const cyanide::signature sig{"C7 A9 ?? 5E 13 B0 F2 4D"};
+
+    target[1000] = 0xC7;
+    target[1001] = 0xA9;
+    target[1003] = 0x5E;
+    target[1004] = 0x13;
+    target[1005] = 0xB0;
+    target[1006] = 0xF2;
+    target[1007] = 0x4D;
+
+    const cyanide::remote_process process{GetCurrentProcessId()};
+
+    // Small window ensures that the pattern crosses the boundary at least once
+    // throughout the scan
+    cyanide::stream_scanner scanner{process, 13};
+
+    const std::array<cyanide::memory_region, 1> regions{
+        {{reinterpret_cast<std::uintptr_t>(target.data()), target.size()}}};
+
+    std::vector<std::uintptr_t> matches;
+
+    scanner.scan(sig, regions, [&matches](std::uintptr_t address) {
+        matches.push_back(address);
+        return true;
+    });
+
+    REQUIRE(matches.size() == 1);
+    REQUIRE(matches[0] == reinterpret_cast<std::uintptr_t>(&target[1000]));
+}
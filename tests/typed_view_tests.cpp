@@ -0,0 +1,163 @@
+#include <cyanide/typed_view.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm> // std::min
+#include <array>
+#include <cstddef> // offsetof
+#include <cstdint>
+#include <cstring> // std::memcpy
+#include <iterator>
+#include <numeric> // std::accumulate
+#include <ranges> // std::ranges::find
+#include <span>
+#include <vector>
+
+static_assert(
+    std::random_access_iterator<cyanide::strided_view<int>::iterator>);
+static_assert(std::ranges::random_access_range<cyanide::typed_view<double>>);
+
+namespace {
+struct entity {
+    std::uint8_t  flags  = 0;
+    std::uint64_t id     = 0;
+    float         health = 0;
+    char          name[20]{};
+};
+
+// Reads the current process memory up to the limit, as if the rest was
+// unmapped
+struct limited_accessor {
+    std::uintptr_t limit = 0;
+    mutable int    reads = 0;
+
+    std::size_t
+    read(std::uintptr_t address, std::span<cyanide::byte_t> buffer) const
+    {
+        ++reads;
+
+        const std::size_t size =
+            address >= limit
+                ? 0
+                : std::min<std::size_t>(buffer.size(), limit - address);
+
+        std::memcpy(
+            buffer.data(),
+            reinterpret_cast<const void *>(address),
+            size);
+
+        return size;
+    }
+};
+} // namespace
+
+TEST_CASE("Viewing the fields of the structs", "[typed_view]")
+{
+    std::vector<entity> entities(4000);
+
+    for (std::size_t i = 0; i < entities.size(); ++i)
+    {
+        entities[i].id     = i * 3;
+        entities[i].health = static_cast<float>(i) / 2;
+    }
+
+    const auto *base = reinterpret_cast<const cyanide::byte_t *>(
+        entities.data());
+
+    const cyanide::strided_view<float> health{
+        base + offsetof(entity, health),
+        1000,
+        sizeof(entity)};
+
+    const cyanide::strided_view<std::uint64_t> ids{
+        base + offsetof(entity, id),
+        1000,
+        sizeof(entity)};
+
+    REQUIRE(health.size() == 1000);
+    REQUIRE(health[10] == 5.0F);
+    REQUIRE(ids[999] == 2997);
+
+    SECTION("Iterating")
+    {
+        REQUIRE(
+            std::accumulate(ids.begin(), ids.end(), std::uint64_t{0})
+            == 3 * 999 * 1000 / 2);
+
+        REQUIRE(ids.end() - ids.begin() == 1000);
+        REQUIRE(*(ids.begin() + 5) == 15);
+        REQUIRE(ids.begin()[7] == 21);
+
+        const auto found = std::ranges::find(health, 100.0F);
+        REQUIRE(found - health.begin() == 200);
+    }
+
+    SECTION("Bulk copying")
+    {
+        // Odd size, so that the tail doesn't fill the whole step
+        std::vector<float>         health_copy(997);
+        std::vector<std::uint64_t> id_copy(2000);
+
+        REQUIRE(health.copy_out(health_copy) == 997);
+        REQUIRE(ids.with_prefetch(8).copy_out(id_copy) == 1000);
+
+        for (std::size_t i = 0; i < health_copy.size(); ++i)
+            REQUIRE(health_copy[i] == entities[i].health);
+
+        for (std::size_t i = 0; i < 1000; ++i)
+            REQUIRE(id_copy[i] == entities[i].id);
+
+        const auto tail = ids.subview(990);
+        REQUIRE(tail.size() == 10);
+        REQUIRE(tail[0] == 2970);
+        REQUIRE(ids.subview(5000).empty());
+    }
+
+    SECTION("Copying through the accessor")
+    {
+        const limited_accessor accessor{
+            reinterpret_cast<std::uintptr_t>(entities.data() + 2000)};
+
+        // Larger than a chunk, the limit is in the second one
+        const cyanide::strided_view<std::uint64_t> remote_ids{
+            ids.address(),
+            4000,
+            sizeof(entity)};
+
+        std::vector<std::uint64_t> id_copy(4000);
+
+        REQUIRE(remote_ids.copy_out(accessor, id_copy) == 2000);
+        REQUIRE(accessor.reads == 2);
+
+        for (std::size_t i = 0; i < 2000; ++i)
+            REQUIRE(id_copy[i] == entities[i].id);
+    }
+}
+
+TEST_CASE("Viewing the packed values", "[typed_view]")
+{
+    std::array<cyanide::byte_t, 4 * 16 + 1> bytes{};
+
+    // Unaligned on purpose
+    for (std::uint32_t i = 0; i < 16; ++i)
+        std::memcpy(bytes.data() + 1 + i * 4, &i, sizeof(i));
+
+    const cyanide::typed_view<std::uint32_t> values{
+        std::span{bytes}.subspan(1)};
+
+    REQUIRE(values.size() == 16);
+    REQUIRE(values.stride() == 4);
+    REQUIRE(values[15] == 15);
+
+    std::array<std::uint32_t, 16> copy{};
+    REQUIRE(values.copy_out(copy) == 16);
+    REQUIRE(copy[9] == 9);
+
+    std::vector<std::uint32_t> collected;
+
+    for (const std::uint32_t value : values)
+        collected.push_back(value);
+
+    REQUIRE(collected.size() == 16);
+    REQUIRE(collected.back() == 15);
+}
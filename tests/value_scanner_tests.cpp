@@ -0,0 +1,183 @@
+#include <cyanide/process_memory.hpp>
+#include <cyanide/value_scanner.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring> // std::memcpy
+#include <span>
+#include <vector>
+
+namespace {
+// Accessor exposing only the specified buffer, so that the test doesn't
+// depend on the rest of the address space
+class buffer_process {
+public:
+    explicit buffer_process(std::span<const cyanide::byte_t> buffer)
+        : buffer_{buffer}
+    {}
+
+    std::size_t
+    read(std::uintptr_t address, std::span<cyanide::byte_t> buffer) const
+    {
+        std::memcpy(
+            buffer.data(),
+            reinterpret_cast<const void *>(address),
+            buffer.size());
+
+        return buffer.size();
+    }
+
+    std::vector<cyanide::memory_region> readable_regions() const
+    {
+        return {{reinterpret_cast<std::uintptr_t>(buffer_.data()),
+                 buffer_.size()}};
+    }
+
+private:
+    std::span<const cyanide::byte_t> buffer_;
+};
+
+template <typename T, std::size_t N>
+std::span<const cyanide::byte_t> as_bytes(const std::array<T, N> &values)
+{
+    return {reinterpret_cast<const cyanide::byte_t *>(values.data()), sizeof(T) * N};
+}
+} // namespace
+
+TEST_CASE("Narrowing down integer values", "[value_scanner]")
+{
+    // Large enough to go through the vectorised path and the scalar tail
+    static std::array<std::int32_t, 1000> memory{};
+
+    memory.fill(7);
+    memory[10]  = 100;
+    memory[500] = 100;
+    memory[999] = 100;
+
+    const buffer_process process{as_bytes(memory)};
+
+    cyanide::value_scanner<std::int32_t, buffer_process> scanner{process};
+
+    scanner.first_scan(cyanide::scan_condition::equal, 100);
+    REQUIRE(scanner.size() == 3);
+
+    memory[10]  = 90;
+    memory[500] = 110;
+
+    scanner.next_scan(cyanide::scan_condition::changed);
+    REQUIRE(scanner.size() == 2);
+
+    scanner.next_scan(cyanide::scan_condition::equal, 90);
+
+    const std::vector<std::uintptr_t> addresses = scanner.addresses();
+    REQUIRE(addresses.size() == 1);
+    REQUIRE(addresses[0] == reinterpret_cast<std::uintptr_t>(&memory[10]));
+}
+
+TEST_CASE("Comparing unsigned and float values", "[value_scanner]")
+{
+    static std::array<std::uint32_t, 200> unsigned_memory{};
+    static std::array<float, 200>         float_memory{};
+
+    unsigned_memory[3]   = 0x90000000;
+    unsigned_memory[150] = 0x10;
+
+    const buffer_process unsigned_process{as_bytes(unsigned_memory)};
+
+    cyanide::value_scanner<std::uint32_t, buffer_process> unsigned_scanner{
+        unsigned_process};
+
+    unsigned_scanner.first_scan(cyanide::scan_condition::greater, 0x8);
+    REQUIRE(unsigned_scanner.size() == 2);
+
+    float_memory.fill(1.0F);
+    float_memory[77] = 2.5F;
+
+    const buffer_process float_process{as_bytes(float_memory)};
+
+    cyanide::value_scanner<float, buffer_process> float_scanner{float_process};
+
+    float_scanner.first_scan(cyanide::scan_condition::greater, 1.5F);
+    REQUIRE(float_scanner.size() == 1);
+
+    float_memory[77] = 2.0F;
+    float_scanner.next_scan(cyanide::scan_condition::decreased);
+    REQUIRE(float_scanner.size() == 1);
+
+    float_scanner.next_scan(cyanide::scan_condition::increased);
+    REQUIRE(float_scanner.size() == 0);
+}
+
+TEST_CASE("Narrowing down byte strings", "[value_scanner]")
+{
+    static std::array<cyanide::byte_t, 300> memory{};
+
+    constexpr std::array<cyanide::byte_t, 3> needle{0xAB, 0xCD, 0xEF};
+
+    std::memcpy(&memory[5], needle.data(), needle.size());
+    std::memcpy(&memory[201], needle.data(), needle.size());
+
+    const buffer_process process{memory};
+
+    cyanide::byte_string_scanner<buffer_process> scanner{process, 3};
+
+    scanner.first_scan(needle);
+    REQUIRE(scanner.size() == 2);
+
+    memory[6] = 0x00;
+
+    scanner.next_scan(cyanide::scan_condition::unchanged);
+
+    const std::vector<std::uintptr_t> addresses = scanner.addresses();
+    REQUIRE(addresses.size() == 1);
+    REQUIRE(addresses[0] == reinterpret_cast<std::uintptr_t>(&memory[201]));
+}
+
+TEST_CASE("Compressing the candidate snapshot", "[value_scanner]")
+{
+    // Spans several chunks of the candidate set
+    static std::vector<std::int32_t> memory(1024 * 1024, 7);
+
+    // Runs of the candidates crossing the chunk boundary
+    for (std::size_t i = 65536 - 100; i < 65536 + 100; ++i)
+        memory[i] = 100;
+
+    memory[3]      = 100;
+    memory[900000] = 100;
+
+    const buffer_process process{std::span{
+        reinterpret_cast<const cyanide::byte_t *>(memory.data()),
+        memory.size() * sizeof(std::int32_t)}};
+
+    cyanide::value_scanner<std::int32_t, buffer_process> scanner{process};
+
+    scanner.first_scan(cyanide::scan_condition::equal, 100);
+    REQUIRE(scanner.size() == 202);
+
+    // Way below the raw bitmap of 128 KB, the equal values are stored once
+    REQUIRE(scanner.memory_usage() < 256);
+
+    memory[3]          = 50;
+    memory[65536 + 99] = 150;
+
+    scanner.next_scan(cyanide::scan_condition::changed);
+    REQUIRE(scanner.size() == 2);
+
+    std::vector<std::int32_t> values;
+
+    scanner.for_each([&values](std::uintptr_t, std::int32_t value) {
+        values.push_back(value);
+    });
+
+    const std::vector<std::int32_t> expected{50, 150};
+    REQUIRE(values == expected);
+
+    scanner.next_scan(cyanide::scan_condition::unchanged);
+    REQUIRE(scanner.size() == 2);
+
+    scanner.next_scan(cyanide::scan_condition::increased);
+    REQUIRE(scanner.size() == 0);
+}